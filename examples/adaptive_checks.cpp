@@ -0,0 +1,277 @@
+//============================================================================
+// Name        : adaptive_checks.cpp
+// Author      : Rahman Salim Zengin
+// Version     :
+// Copyright   : rsz@gufatek.com
+// Description : "Adaptive" against its predicate while it learns
+//============================================================================
+
+/*
+ * Every row an "Adaptive" predicate is called with must give the result of the
+ * predicate it is made of, before, while and after it reorders its links. The
+ * rows of a five link chain of ints are skewed, so that by the estimated costs
+ * the links are evaluated as written when they rarely fail, in the learned order
+ * when a late link fails most often, and without branches when each link fails
+ * half of the time. The failing link changes halfway through a drifting
+ * distribution, and the order must follow it. Links of strings are evaluated in
+ * the order, and a link of a non-reorderable type must keep its place, so it is
+ * compared only when the links before it hold. A frozen "Adaptive" keeps its
+ * order, "set_order" takes a permutation of the links and throws
+ * "std::invalid_argument" on anything else, and const calls of a learned one,
+ * from another thread as well, change nothing.
+ * A copy of a learned "Adaptive" keeps learning in another thread. On POSIX
+ * without NDEBUG, non-const calls of one "Adaptive" from a second thread must
+ * fail its assertion, checked in a child process.
+ */
+
+#include <cstdio>
+#include <cstddef>
+#include <array>
+#include <functional>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+#if defined(__unix__) && !defined(NDEBUG)
+#include <signal.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+#ifdef __GNUG__
+#include "../include/cmp.hpp"
+#else
+#include "..\include\cmp.hpp"
+#endif
+
+#include "check.hpp"
+
+namespace {
+
+	using Row = std::array<int, 6>;
+
+	// "a0 < a1 <= a2 < a3 <= a4 < a5", link "inx" is strict for an even "inx"
+	const auto pred = cmp::chain << cmp::arg<0> < cmp::arg<1> <= cmp::arg<2> < cmp::arg<3> <= cmp::arg<4> < cmp::arg<5>;
+	using Learning = cmp::Adaptive<std::decay_t<decltype(pred)>>;
+
+	// A row whose link "inx" fails with the probability "fails[inx]", a set bit of "strict" is a "<" link
+	Row make_row(std::mt19937_64& engine, const std::array<double, 5>& fails, unsigned strict_links = 0x15) {
+		std::uniform_real_distribution<double> uniform(0, 1);
+		Row row;
+		row[0] = int(engine() % 100) - 50;
+		for (std::size_t inx = 0; inx < 5; ++inx) {
+			const int step = int(engine() % 3);
+			const bool strict = (strict_links >> inx) & 1;
+			if (uniform(engine) < fails[inx])
+				row[inx + 1] = row[inx] - step - !strict;
+			else
+				row[inx + 1] = row[inx] + step + strict;
+		}
+		return row;
+	}
+
+	template<typename Adaptive>
+	void check_rows(Adaptive& learning, std::mt19937_64& engine, const std::array<double, 5>& fails, std::size_t count,
+		const char* name) {
+		for (std::size_t call = 0; call < count; ++call) {
+			const Row row = make_row(engine, fails);
+			const bool expected = std::apply(pred, row);
+			const bool result = std::apply(learning, row);
+			check::expect(result == expected, "%s, call %zu, row %d %d %d %d %d %d: %d, expected %d", name, call, row[0],
+				row[1], row[2], row[3], row[4], row[5], int(result), int(expected));
+		}
+	}
+
+	// Enough calls to sample and reorder several times
+	constexpr std::size_t learning_calls = 8 * Learning::sample_period * Learning::reorder_samples;
+
+	void check_plans() {
+		std::mt19937_64 engine(23);
+		{
+			// Rarely failing links cost the least as written
+			Learning learning(pred);
+			check_rows(learning, engine, { 0.01, 0, 0, 0, 0.01 }, learning_calls, "written");
+		}
+		{
+			// The last link failing most often is moved first and evaluated in the order
+			Learning learning(pred);
+			check_rows(learning, engine, { 0, 0.02, 0, 0, 0.95 }, learning_calls, "ordered");
+			check::expect(learning.order()[0] == 4, "ordered: link %d first, expected 4", int(learning.order()[0]));
+		}
+		{
+			// Unpredictable links cost the least without branches
+			Learning learning(pred);
+			check_rows(learning, engine, { 0.5, 0.5, 0.5, 0.5, 0.5 }, learning_calls, "branchless");
+		}
+		{
+			Learning learning(pred);
+			check_rows(learning, engine, { 0, 0, 0.1, 0, 0.9 }, learning_calls, "drifting, first half");
+			check::expect(learning.order()[0] == 4, "drifting, first half: link %d first, expected 4", int(learning.order()[0]));
+			check_rows(learning, engine, { 0.9, 0, 0.1, 0, 0 }, learning_calls, "drifting, second half");
+			check::expect(learning.order()[0] == 0 && learning.order()[1] == 2,
+				"drifting, second half: links %d %d first, expected 0 2", int(learning.order()[0]), int(learning.order()[1]));
+		}
+	}
+
+	void check_strings() {
+		std::mt19937_64 engine(24);
+		const std::string lo = "m", hi = "t";
+		const auto words = cmp::chain << lo <= cmp::arg<0> < cmp::arg<1> < hi;
+		auto learning = cmp::adaptive(words);
+		for (std::size_t call = 0; call < learning_calls; ++call) {
+			// The last link fails most often
+			const std::string a(1, char('n' + engine() % 3)), b(1, char(engine() % 8 == 0 ? 'p' : 'q' + engine() % 6));
+			const bool expected = words(a, b);
+			check::expect(learning(a, b) == expected, "strings \"%s\" \"%s\": %d", a.c_str(), b.c_str(), int(expected));
+		}
+		check::expect(learning.order()[0] == 2, "strings: link %d first, expected 2", int(learning.order()[0]));
+	}
+
+	// Not reorderable, counting its comparisons
+	struct Num {
+		int value;
+		static inline std::size_t compared = 0;
+	};
+
+	bool operator<(const Num& lhs, int rhs) { ++Num::compared; return lhs.value < rhs; }
+	bool operator<(int lhs, const Num& rhs) { ++Num::compared; return lhs < rhs.value; }
+
+	void check_fixed() {
+		std::mt19937_64 engine(25);
+		// Links 0 to 2 may be reordered among themselves, links 3 and 4 compare a "Num"
+		const auto mixed = cmp::chain << cmp::arg<0> < cmp::arg<1> < cmp::arg<2> < cmp::arg<3> < cmp::arg<4> < cmp::arg<5>;
+		auto learning = cmp::adaptive(mixed);
+		for (std::size_t call = 0; call < learning_calls; ++call) {
+			const Row row = make_row(engine, { 0, 0.1, 0.8, 0.3, 0.3 }, 0x1f);
+			const Num num{ row[4] };
+			const bool expected = row[0] < row[1] && row[1] < row[2] && row[2] < row[3] && row[3] < row[4] &&
+				row[4] < row[5];
+			Num::compared = 0;
+			const bool result = learning(row[0], row[1], row[2], row[3], num, row[5]);
+			check::expect(result == expected, "fixed, call %zu: %d, expected %d", call, int(result), int(expected));
+			const bool reached = row[0] < row[1] && row[1] < row[2] && row[2] < row[3];
+			check::expect(reached || Num::compared == 0, "fixed, call %zu: a Num compared before the links before it hold",
+				call);
+		}
+		check::expect(learning.order()[0] == 2, "fixed: link %d first, expected 2", int(learning.order()[0]));
+	}
+
+	void check_freeze() {
+		std::mt19937_64 engine(26);
+		Learning learning(pred);
+		check_rows(learning, engine, { 0, 0, 0, 0.9, 0 }, learning_calls, "before freeze");
+		const Learning::order_type learned = learning.order();
+		check::expect(learned[0] == 3, "before freeze: link %d first, expected 3", int(learned[0]));
+		learning.freeze();
+		check::expect(learning.frozen(), "frozen() after freeze()");
+		check_rows(learning, engine, { 0.9, 0, 0, 0, 0 }, learning_calls, "frozen");
+		check::expect(learning.order() == learned, "frozen: the order changed");
+		learning.unfreeze();
+		check::expect(!learning.frozen(), "frozen() after unfreeze()");
+		check_rows(learning, engine, { 0.9, 0, 0, 0, 0 }, learning_calls, "unfrozen");
+		check::expect(learning.order()[0] == 0, "unfrozen: link %d first, expected 0", int(learning.order()[0]));
+	}
+
+	void check_set_order() {
+		std::mt19937_64 engine(27);
+		Learning learning(pred);
+		const Learning::order_type order = { 4, 2, 0, 3, 1 };
+		learning.set_order(order);
+		check::expect(learning.order() == order, "set_order: the order isn't set");
+		learning.freeze();
+		check_rows(learning, engine, { 0.3, 0.3, 0.3, 0.3, 0.3 }, learning_calls, "set_order");
+
+		const Learning::order_type invalid[] = { { 0, 1, 2, 3, 3 }, { 0, 1, 2, 3, 5 }, { 4, 4, 4, 4, 4 }, { 1, 2, 3, 4, 255 } };
+		for (const auto& bad : invalid) {
+			bool thrown = false;
+			try {
+				learning.set_order(bad);
+			}
+			catch (const std::invalid_argument&) {
+				thrown = true;
+			}
+			check::expect(thrown, "set_order of %d %d %d %d %d doesn't throw std::invalid_argument", int(bad[0]),
+				int(bad[1]), int(bad[2]), int(bad[3]), int(bad[4]));
+			check::expect(learning.order() == order, "set_order of an invalid order changed the order");
+		}
+	}
+
+	void check_const() {
+		std::mt19937_64 engine(28);
+		Learning learning(pred);
+		check_rows(learning, engine, { 0, 0.7, 0, 0.2, 0 }, learning_calls, "learning");
+		const Learning::order_type learned = learning.order();
+		const Learning& shared = learning;
+		std::vector<Row> rows;
+		for (std::size_t call = 0; call < learning_calls; ++call)
+			rows.push_back(make_row(engine, { 0.4, 0, 0, 0, 0.6 }));
+		// Counts the wrong results, "check::expect" is called by the main thread only
+		const auto call_all = [&rows, &shared](std::size_t& wrong) {
+			for (const Row& row : rows)
+				wrong += std::apply(shared, row) != std::apply(pred, row);
+		};
+		std::size_t wrong = 0, wrong_other = 0, wrong_concurrent = 0;
+		call_all(wrong);
+		std::thread other(call_all, std::ref(wrong_other));
+		call_all(wrong_concurrent);
+		other.join();
+		check::expect(wrong == 0, "const: %zu wrong results", wrong);
+		check::expect(wrong_other == 0, "const, another thread: %zu wrong results", wrong_other);
+		check::expect(wrong_concurrent == 0, "const, concurrently: %zu wrong results", wrong_concurrent);
+		check::expect(shared.order() == learned, "const calls changed the order");
+	}
+
+	void check_owner() {
+		std::mt19937_64 engine(29);
+		Learning learning(pred);
+		check_rows(learning, engine, { 0, 0.7, 0, 0.2, 0 }, learning_calls, "owner");
+		// A copy belongs to the thread of its first non-const call
+		Learning copy = learning;
+		std::size_t wrong = 0;
+		std::thread other([&copy, &wrong] {
+			std::mt19937_64 other_engine(30);
+			for (std::size_t call = 0; call < learning_calls; ++call) {
+				const Row row = make_row(other_engine, { 0, 0, 0, 0.1, 0.7 });
+				wrong += std::apply(copy, row) != std::apply(pred, row);
+			}
+		});
+		other.join();
+		check::expect(wrong == 0, "copy, another thread: %zu wrong results", wrong);
+		check_rows(learning, engine, { 0, 0.7, 0, 0.2, 0 }, learning_calls, "owner, after the copy");
+		check::expect(copy.order()[0] == 4 && learning.order()[0] == 1, "copy learned %d, the original %d, expected 4 and 1",
+			int(copy.order()[0]), int(learning.order()[0]));
+
+#if defined(__unix__) && !defined(NDEBUG)
+		// A second thread calling the same "Adaptive" aborts the child
+		std::fflush(nullptr);
+		const pid_t child = fork();
+		if (child == 0) {
+			std::freopen("/dev/null", "w", stderr);
+			std::thread second([&learning] {
+				std::mt19937_64 second_engine(31);
+				check_rows(learning, second_engine, { 0, 0.7, 0, 0.2, 0 }, learning_calls, "second thread");
+			});
+			second.join();
+			_exit(0);
+		}
+		int status = 0;
+		check::expect(child > 0 && waitpid(child, &status, 0) == child && WIFSIGNALED(status) && WTERMSIG(status) == SIGABRT,
+			"non-const calls from a second thread didn't fail the assertion");
+#endif
+	}
+
+}
+
+int main() {
+	check_plans();
+	check_strings();
+	check_fixed();
+	check_freeze();
+	check_set_order();
+	check_const();
+	check_owner();
+	return check::report("adaptive");
+}
@@ -0,0 +1,573 @@
+//============================================================================
+// Name        : benchmark.cpp
+// Author      : Rahman Salim Zengin
+// Version     :
+// Copyright   : rsz@gufatek.com
+// Description : Benchmarks of the chain engines and the batch algorithms
+//============================================================================
+
+/*
+ * Build: g++ -std=c++17 -O2 -pthread benchmark.cpp -o benchmark
+ * Run:   ./benchmark [--max-size=N] [group...]    e.g. ./benchmark forms columns
+ *
+ * "--max-size" caps the data of the "equal_range" group, 1e7 elements by
+ * default. Its sizes 1e8 and 1e9 take about 8 bytes per element, 8 GB at 1e9,
+ * e.g. ./benchmark --max-size=1e9 equal_range
+ *
+ * The "strings" group depends on the standard, a C++20 build compares the strings
+ * through the three-way comparison: g++ -std=c++20 -O2 -pthread benchmark.cpp -o benchmark20
+ *
+ * Each time is the fastest of five runs, in nanoseconds per row (or per query).
+ * The cost of the instrumentation is the "instrumentation" group of a build
+ * with -std=c++20 -DCMP_INSTRUMENT against the same group of a build without it.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <random>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#ifdef __GNUG__
+#include "../include/cmp.hpp"
+#else
+#include "..\include\cmp.hpp"
+#endif
+
+namespace {
+
+	using Clock = std::chrono::steady_clock;
+
+	// Checksums of the runs, so the measured work isn't optimized away
+	volatile std::size_t checksum;
+
+	std::mt19937_64 random_engine(42);
+
+	// Largest data of the "equal_range" group, set by "--max-size"
+	std::size_t max_size = 10000000;
+
+	template<typename Body>
+	double measure(std::size_t items, Body&& body) {
+		double best = std::numeric_limits<double>::max();
+		for (int run = 0; run < 5; ++run) {
+			const auto start = Clock::now();
+			checksum = checksum + body();
+			best = std::min(best, std::chrono::duration<double, std::nano>(Clock::now() - start).count());
+		}
+		return best / double(items);
+	}
+
+	// Values ordered the same as "key", strings are zero padded
+	template<typename T>
+	T make_value(std::size_t key) { return T(key); }
+
+	template<>
+	std::string make_value<std::string>(std::size_t key) {
+		char text[32];
+		std::snprintf(text, sizeof(text), "item%012zu", key);
+		return text;
+	}
+
+	// Rows of "length" ascending values, "pass" percent of them are chains, the others fail at a random link
+	template<typename T>
+	std::vector<T> chain_rows(std::size_t rows, std::size_t length, int pass) {
+		std::uniform_int_distribution<int> percent(0, 99);
+		std::uniform_int_distribution<std::size_t> link(1, length - 1);
+		std::uniform_int_distribution<std::size_t> step(1, 1000);
+		std::vector<T> data;
+		data.reserve(rows * length);
+		for (std::size_t row = 0; row < rows; ++row) {
+			const std::size_t first = data.size();
+			for (std::size_t key = step(random_engine), inx = 0; inx < length; ++inx, key += step(random_engine))
+				data.push_back(make_value<T>(key));
+			if (percent(random_engine) >= pass) {
+				const std::size_t inx = first + link(random_engine);
+				std::swap(data[inx - 1], data[inx]);
+			}
+		}
+		return data;
+	}
+
+	template<typename Root, typename T, std::size_t... Inx>
+	bool root_form(const Root& root, const T* v, std::index_sequence<Inx...>) {
+		return bool(((root << v[0]) < ... < v[Inx + 1]));
+	}
+
+	// The predicate "root << arg<0> < arg<1> < ... < arg<Length - 1>"
+	template<typename Root, std::size_t... Inx>
+	auto predicate_form(const Root& root, std::index_sequence<Inx...>) {
+		return ((root << cmp::arg<0>) < ... < cmp::arg<Inx + 1>);
+	}
+
+	template<typename Pred, typename T, std::size_t... Inx>
+	bool call_form(const Pred& pred, const T* v, std::index_sequence<Inx...>) {
+		return pred(v[Inx]...);
+	}
+
+	template<typename T, std::size_t... Inx>
+	bool hand_form(const T* v, std::index_sequence<Inx...>) {
+		return ((v[Inx] < v[Inx + 1]) && ...);
+	}
+
+	template<typename T, std::size_t Length>
+	void chain_forms(const char* type, std::size_t rows) {
+		const auto links = std::make_index_sequence<Length - 1>{};
+		const auto operands = std::make_index_sequence<Length>{};
+		const auto pred = predicate_form(cmp::chain, links);
+		for (int pass : { 1, 10, 50, 90, 99 }) {
+			const std::vector<T> data = chain_rows<T>(rows, Length, pass);
+			const auto run = [&](auto form) {
+				return measure(rows, [&] {
+					std::size_t count = 0;
+					for (std::size_t row = 0; row < rows; ++row)
+						count += form(data.data() + row * Length);
+					return count;
+				});
+			};
+			std::printf("%-8s %6zu %5d%% %10.2f %10.2f %10.2f %10.2f %10.2f %10.2f\n", type, Length, pass,
+				run([&](const T* v) { return root_form(cmp::chain_root, v, links); }),
+				run([&](const T* v) { return root_form(cmp::branchless_root, v, links); }),
+				run([&](const T* v) { return root_form(cmp::chain, v, links); }),
+				run([&](const T* v) { return root_form(cmp::branchless_chain, v, links); }),
+				run([&](const T* v) { return call_form(pred, v, operands); }),
+				run([&](const T* v) { return hand_form(v, links); }));
+		}
+	}
+
+	template<typename T>
+	void chain_forms_of(const char* type, std::size_t rows) {
+		chain_forms<T, 2>(type, rows);
+		chain_forms<T, 4>(type, rows);
+		chain_forms<T, 8>(type, rows);
+		chain_forms<T, 16>(type, rows);
+	}
+
+	// chain_root (Node engine), chain (Conductor engine), their branchless policies, a placeholder predicate and "&&"
+	void forms() {
+		std::printf("%-8s %6s %6s %10s %10s %10s %10s %10s %10s\n", "type", "length", "pass",
+			"node", "node/bl", "chain", "chain/bl", "pred", "hand");
+		chain_forms_of<int>("int", 1 << 16);
+		chain_forms_of<double>("double", 1 << 16);
+		chain_forms_of<std::string>("string", 1 << 13);
+	}
+
+	// A lazy operand is computed only if the links before it hold
+	void lazy() {
+		const std::size_t n = 1 << 16;
+		std::map<int, int> table;
+		for (int key = 0; key < 10000; ++key)
+			table[key] = key * 7 % 10000;
+		std::uniform_int_distribution<int> key(0, 9999);
+		std::vector<int> keys(n);
+		for (auto& value : keys)
+			value = key(random_engine);
+
+		std::printf("%-24s %10s %10s\n", "first link passes", "eager", "lazy");
+		for (int limit : { 100, 5000, 9900 }) {
+			const double eager = measure(n, [&] {
+				std::size_t count = 0;
+				for (int x : keys)
+					count += bool(cmp::chain_root << x < limit <= table.find(x)->second);
+				return count;
+			});
+			const double deferred = measure(n, [&] {
+				std::size_t count = 0;
+				for (int x : keys)
+					count += bool(cmp::chain_root << x < limit <= cmp::lazy([&] { return table.find(x)->second; }));
+				return count;
+			});
+			std::printf("%23d%% %10.2f %10.2f\n", limit / 100, eager, deferred);
+		}
+	}
+
+	/*
+	 * String range filter, the literal bounds against std::string elements, and the stored forms.
+	 * Links of strings are compared by "<" and "<=" in C++17, by a three-way comparison of
+	 * string views in C++20, the row is named after the build.
+	 */
+	void strings() {
+		const std::size_t n = 1 << 18;
+		std::vector<std::string> words(n);
+		std::uniform_int_distribution<std::size_t> key(0, 999999);
+		for (auto& word : words)
+			word = make_value<std::string>(key(random_engine));
+
+		const auto in_range = cmp::chain << "item000000100000" <= cmp::_ < "item000000200000";
+		const auto in_keys = cmp::string_range(in_range);
+#if defined(CMP_THREE_WAY)
+		const char* const build = "three-way";
+#else
+		const char* const build = "operators";
+#endif
+
+		std::printf("%-10s %10s %10s %10s %10s %10s %10s\n", "", "node", "chain", "hand",
+			"predicate", "str_range", "batch");
+		std::printf("%-10s %10.2f %10.2f %10.2f %10.2f %10.2f %10.2f\n", build,
+			measure(n, [&] {
+				std::size_t count = 0;
+				for (const auto& word : words)
+					count += bool(cmp::chain_root << "item000000100000" <= word < "item000000200000");
+				return count;
+			}),
+			measure(n, [&] {
+				std::size_t count = 0;
+				for (const auto& word : words)
+					count += bool(cmp::chain << "item000000100000" <= word < "item000000200000");
+				return count;
+			}),
+			measure(n, [&] {
+				std::size_t count = 0;
+				for (const auto& word : words)
+					count += "item000000100000" <= word && word < "item000000200000";
+				return count;
+			}),
+			measure(n, [&] {
+				std::size_t count = 0;
+				for (const auto& word : words)
+					count += in_range(word);
+				return count;
+			}),
+			measure(n, [&] {
+				std::size_t count = 0;
+				for (const auto& word : words)
+					count += in_keys(word);
+				return count;
+			}),
+			measure(n, [&] { return cmp::select_count(in_range, words); }));
+	}
+
+	// A chain stored in a variable before it is evaluated, against the same chain inline
+	void stored() {
+		const std::size_t n = 1 << 20;
+		std::vector<int> values(n);
+		std::uniform_int_distribution<int> value(0, 99);
+		for (auto& x : values)
+			x = value(random_engine);
+
+		std::printf("%-10s %10s %10s\n", "", "stored", "inline");
+		std::printf("%-10s %10.2f %10.2f\n", "node",
+			measure(n, [&] {
+				std::size_t count = 0;
+				for (int x : values) {
+					const auto expression = cmp::chain_root << 25 < x <= 75;
+					count += bool(expression);
+				}
+				return count;
+			}),
+			measure(n, [&] {
+				std::size_t count = 0;
+				for (int x : values)
+					count += bool(cmp::chain_root << 25 < x <= 75);
+				return count;
+			}));
+	}
+
+	// Histogram by cmp::buckets, a chain of ifs and std::upper_bound
+	template<std::size_t Bounds>
+	void buckets_of(const std::vector<int>& values) {
+		std::vector<int> bounds(Bounds);
+		for (std::size_t inx = 0; inx < Bounds; ++inx)
+			bounds[inx] = int((inx + 1) * 1000000 / (Bounds + 1));
+		const bool strict_bounds[Bounds] = {};
+		const cmp::Buckets<int> bins(bounds.data(), strict_bounds, Bounds);
+		std::vector<std::size_t> counts(Bounds + 1);
+
+		std::printf("%8zu %10.2f %10.2f %10.2f\n", Bounds,
+			measure(values.size(), [&] {
+				std::fill(counts.begin(), counts.end(), 0);
+				bins.histogram(values.data(), values.size(), counts.data());
+				return counts[0];
+			}),
+			measure(values.size(), [&] {
+				std::fill(counts.begin(), counts.end(), 0);
+				for (int x : values) {
+					std::size_t bin = 0;
+					while (bin < Bounds && bounds[bin] <= x)
+						++bin;
+					++counts[bin];
+				}
+				return counts[0];
+			}),
+			measure(values.size(), [&] {
+				std::fill(counts.begin(), counts.end(), 0);
+				for (int x : values)
+					++counts[std::size_t(std::upper_bound(bounds.begin(), bounds.end(), x) - bounds.begin())];
+				return counts[0];
+			}));
+	}
+
+	void buckets() {
+		std::vector<int> values(1 << 20);
+		std::uniform_int_distribution<int> value(0, 999999);
+		for (auto& x : values)
+			x = value(random_engine);
+		std::printf("%8s %10s %10s %10s\n", "bounds", "buckets", "ifs", "upper_bnd");
+		buckets_of<4>(values);
+		buckets_of<16>(values);
+		buckets_of<64>(values);
+		buckets_of<1024>(values);
+	}
+
+	// Rule set lookups, each rule is a narrow random range
+	void rules() {
+		std::printf("%10s %12s %12s %10s\n", "rules", "insert (ns)", "match (ns)", "matches");
+		for (std::size_t size : { std::size_t(10000), std::size_t(1000000) }) {
+			std::uniform_int_distribution<int> lower(0, 99999999);
+			std::uniform_int_distribution<int> width(1, 10000);
+			std::vector<std::pair<int, int>> ranges(size);
+			for (auto& range : ranges) {
+				range.first = lower(random_engine);
+				range.second = range.first + width(random_engine);
+			}
+			cmp::Rule_set<int> rules;
+			const double insert = measure(size, [&] {
+				rules = cmp::Rule_set<int>();
+				for (const auto& range : ranges)
+					rules.insert(cmp::chain << range.first <= cmp::_ < range.second);
+				return rules.size();
+			});
+			std::vector<int> queries(1 << 16);
+			for (auto& x : queries)
+				x = lower(random_engine);
+			std::size_t matches = 0;
+			const double match = measure(queries.size(), [&] {
+				matches = 0;
+				rules.match(queries.data(), queries.size(), [&matches](std::size_t, std::size_t) { ++matches; });
+				return matches;
+			});
+			std::printf("%10zu %12.2f %12.2f %10.2f\n", size, insert, match, double(matches) / double(queries.size()));
+		}
+	}
+
+	// A chain built at runtime against the same template predicate
+	void dynamic() {
+		const std::size_t n = 1 << 20;
+		std::vector<double> a(n), b(n);
+		std::uniform_real_distribution<double> value(0, 1);
+		for (std::size_t inx = 0; inx < n; ++inx) {
+			a[inx] = value(random_engine);
+			b[inx] = value(random_engine);
+		}
+		const auto predicate = cmp::chain << 0.25 < cmp::arg<0> <= cmp::arg<1> < 0.75;
+		const auto runtime = cmp::dynamic_chain<double>({ 0.25, cmp::arg<0>, cmp::arg<1>, 0.75 },
+			{ cmp::Link::LowerThan, cmp::Link::LowerThanEqual, cmp::Link::LowerThan });
+		const double* const columns[] = { a.data(), b.data() };
+		std::vector<std::uint64_t> mask((n + 63) / 64);
+
+		std::printf("%-10s %10s %10s\n", "", "template", "dynamic");
+		std::printf("%-10s %10.2f %10.2f\n", "call",
+			measure(n, [&] {
+				std::size_t count = 0;
+				for (std::size_t inx = 0; inx < n; ++inx)
+					count += predicate(a[inx], b[inx]);
+				return count;
+			}),
+			measure(n, [&] {
+				std::size_t count = 0;
+				for (std::size_t inx = 0; inx < n; ++inx)
+					count += runtime(a[inx], b[inx]);
+				return count;
+			}));
+		std::printf("%-10s %10.2f %10.2f\n", "batch",
+			measure(n, [&] { return cmp::select_count(predicate, cmp::columns(a, b), 1); }),
+			measure(n, [&] {
+				runtime.select_mask(columns, n, mask.data());
+				return std::size_t(mask[0]);
+			}));
+	}
+
+	// Sorted checks against std::is_sorted
+	void is_chain() {
+		const std::size_t n = 1 << 24;
+		std::vector<int> values(n);
+		for (std::size_t inx = 0; inx < n; ++inx)
+			values[inx] = int(inx / 3);
+
+		std::printf("%-12s %10s %10s\n", "", "cmp", "std");
+		std::printf("%-12s %10.3f %10.3f\n", "non-strict",
+			measure(n, [&] { return std::size_t(cmp::is_chain(values, cmp::non_strict)); }),
+			measure(n, [&] { return std::size_t(std::is_sorted(values.begin(), values.end())); }));
+		values[n - n / 4] = -1;
+		std::printf("%-12s %10.3f %10.3f\n", "until",
+			measure(n, [&] { return cmp::chain_until(values, cmp::non_strict); }),
+			measure(n, [&] { return std::size_t(std::is_sorted_until(values.begin(), values.end()) - values.begin()); }));
+	}
+
+	// "0.4 < a <= b <= c < 0.6" over three columns, by the number of threads
+	void columns() {
+		const std::size_t n = 1 << 23;
+		std::vector<double> a(n), b(n), c(n);
+		std::uniform_real_distribution<double> value(0, 1);
+		for (std::size_t inx = 0; inx < n; ++inx) {
+			a[inx] = value(random_engine);
+			b[inx] = value(random_engine);
+			c[inx] = value(random_engine);
+		}
+		const auto predicate = cmp::chain << 0.4 < cmp::arg<0> <= cmp::arg<1> <= cmp::arg<2> < 0.6;
+		const auto data = cmp::columns(a, b, c);
+		std::vector<std::size_t> index(n);
+
+		std::printf("%-10s %10s %10s\n", "threads", "count", "index");
+		std::printf("%-10s %10.3f %10s\n", "row loop", measure(n, [&] {
+			std::size_t count = 0;
+			for (std::size_t inx = 0; inx < n; ++inx)
+				count += predicate(a[inx], b[inx], c[inx]);
+			return count;
+		}), "");
+		const std::size_t cores = std::max(1u, std::thread::hardware_concurrency());
+		for (std::size_t threads = 1; threads <= cores; threads *= 2)
+			std::printf("%-10zu %10.3f %10.3f\n", threads,
+				measure(n, [&] { return cmp::select_count(predicate, data, threads); }),
+				measure(n, [&] { return cmp::select_index(predicate, data, index.data(), threads); }));
+	}
+
+	// Range queries of sorted data, per query, up to "max_size" elements
+	void equal_range() {
+		std::printf("%-10s %12s %12s %12s %12s\n", "size", "linear", "lower_bound", "equal_range", "eytzinger");
+		for (std::size_t n : { std::size_t(1000), std::size_t(100000), std::size_t(10000000), std::size_t(100000000),
+			std::size_t(1000000000) }) {
+			if (n > max_size)
+				break;
+			std::vector<int> values(n);
+			std::uniform_int_distribution<int> value(0, std::numeric_limits<int>::max() - 1000000);
+			for (auto& x : values)
+				x = value(random_engine);
+			std::sort(values.begin(), values.end());
+			const auto index = cmp::eytzinger_index(values);
+			std::vector<int> queries(1 << 16);
+			for (auto& x : queries)
+				x = value(random_engine);
+			const std::size_t linear_queries = std::max<std::size_t>(4, 1000000 / n);
+
+			std::printf("%-10zu %12.1f %12.1f %12.1f %12.1f\n", n,
+				measure(linear_queries, [&] {
+					std::size_t count = 0;
+					for (std::size_t inx = 0; inx < linear_queries; ++inx)
+						count += cmp::select_count(cmp::chain << queries[inx] <= cmp::_ < queries[inx] + 1000000, values);
+					return count;
+				}),
+				measure(queries.size(), [&] {
+					std::size_t count = 0;
+					for (int lo : queries)
+						count += std::size_t(std::lower_bound(values.begin(), values.end(), lo + 1000000) -
+							std::lower_bound(values.begin(), values.end(), lo));
+					return count;
+				}),
+				measure(queries.size(), [&] {
+					std::size_t count = 0;
+					for (int lo : queries)
+						count += cmp::equal_range(values, cmp::chain << lo <= cmp::_ < lo + 1000000).size();
+					return count;
+				}),
+				measure(queries.size(), [&] {
+					std::size_t count = 0;
+					for (int lo : queries)
+						count += cmp::equal_range(index, cmp::chain << lo <= cmp::_ < lo + 1000000).size();
+					return count;
+				}));
+		}
+	}
+
+	/*
+	 * "0.4 < a <= b <= c < 0.6" over skewed columns, the first link fails in half of
+	 * the rows and the last one in "fail" percent, so the written order branches
+	 * unpredictably first. Written order, "cmp::adaptive" learning, the same learned
+	 * and frozen, called const (as shared by threads), and the learned order by hand.
+	 */
+	void adaptive() {
+		const std::size_t n = 1 << 20;
+		std::uniform_real_distribution<double> unit(0, 1);
+		std::uniform_int_distribution<int> percent(0, 99);
+
+		std::printf("%-8s %10s %10s %10s %10s %10s\n", "fail", "written", "adaptive", "frozen", "shared", "hand");
+		for (int fail : { 90, 95, 99 }) {
+			std::vector<double> a(n), b(n), c(n);
+			for (std::size_t inx = 0; inx < n; ++inx) {
+				a[inx] = percent(random_engine) < 50 ? 0.4 * unit(random_engine) : 0.4 + 0.1 * unit(random_engine);
+				b[inx] = a[inx] + 0.01 * unit(random_engine);
+				c[inx] = percent(random_engine) < fail ? 0.6 + 0.4 * unit(random_engine) : b[inx] + 0.05 * unit(random_engine);
+			}
+			const auto written = cmp::chain << 0.4 < cmp::arg<0> <= cmp::arg<1> <= cmp::arg<2> < 0.6;
+			const auto run = [&](auto pred) {
+				return measure(n, [&] {
+					std::size_t count = 0;
+					for (std::size_t inx = 0; inx < n; ++inx)
+						count += pred(a[inx], b[inx], c[inx]);
+					return count;
+				});
+			};
+			auto learned = cmp::adaptive(written);
+			for (std::size_t inx = 0; inx < n; ++inx)
+				learned(a[inx], b[inx], c[inx]);
+			learned.freeze();
+			const auto& shared = learned;
+			std::printf("%7d%% %10.2f %10.2f %10.2f %10.2f %10.2f\n", fail,
+				run(written),
+				run(cmp::adaptive(written)),
+				run(learned),
+				run(std::cref(shared)),
+				run([](double x, double y, double z) { return z < 0.6 && 0.4 < x && x <= y && y <= z; }));
+		}
+	}
+
+	// The chain forms counted per call site, the report follows if CMP_INSTRUMENT is defined
+	void instrumentation() {
+#if defined(CMP_INSTRUMENT)
+		std::printf("instrumentation on\n");
+#else
+		std::printf("instrumentation off\n");
+#endif
+		std::printf("%-8s %6s %6s %10s %10s %10s %10s %10s %10s\n", "type", "length", "pass",
+			"node", "node/bl", "chain", "chain/bl", "pred", "hand");
+		chain_forms<int, 4>("int", 1 << 16);
+		chain_forms<int, 8>("int", 1 << 16);
+#if defined(CMP_INSTRUMENT)
+		cmp::instrument::report(std::cout);
+#endif
+	}
+
+	const std::pair<const char*, void(*)()> groups[] = {
+		{ "forms", forms },
+		{ "lazy", lazy },
+		{ "strings", strings },
+		{ "stored", stored },
+		{ "buckets", buckets },
+		{ "rules", rules },
+		{ "dynamic", dynamic },
+		{ "is_chain", is_chain },
+		{ "columns", columns },
+		{ "equal_range", equal_range },
+		{ "adaptive", adaptive },
+		{ "instrumentation", instrumentation },
+	};
+
+}
+
+int main(int argc, char* argv[]) {
+	std::vector<const char*> names;
+	for (int inx = 1; inx < argc; ++inx) {
+		if (std::strncmp(argv[inx], "--max-size=", 11) == 0)
+			max_size = std::size_t(std::strtod(argv[inx] + 11, nullptr));
+		else
+			names.push_back(argv[inx]);
+	}
+	for (const auto& group : groups) {
+		const bool selected = names.empty() || std::any_of(names.begin(), names.end(),
+			[&](const char* name) { return std::strcmp(name, group.first) == 0; });
+		if (!selected)
+			continue;
+		std::printf("== %s\n", group.first);
+		group.second();
+		std::printf("\n");
+	}
+	return 0;
+}
@@ -0,0 +1,202 @@
+//============================================================================
+// Name        : bucket_checks.cpp
+// Author      : Rahman Salim Zengin
+// Version     :
+// Copyright   : rsz@gufatek.com
+// Description : Bins and histograms of "Buckets" against a chain of ifs
+//============================================================================
+
+/*
+ * A value is in bin k if it passes the first k bounds, ">= b" of a "< b" bound
+ * and "> b" of a "<= b" one, checked by a plain chain of ifs. Random sorted
+ * bounds of mixed "<" and "<=" are checked for int32, uint32, int64, float and
+ * double. The bounds include the limits of the type, so a "<= max" bound leaves
+ * no value to the following bins, and the infinities of the floating point
+ * types. The data include NaN, which is in bin 0, and the infinities.
+ * "operator()" and "histogram" are checked at 0 to 80 bounds, across the limit
+ * of 64 bounds of the SIMD histogram. Each histogram kernel of the instruction
+ * sets "isa_level()" allows is called directly up to the limit as well.
+ */
+
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <algorithm>
+#include <limits>
+#include <random>
+#include <vector>
+
+#ifdef __GNUG__
+#include "../include/cmp.hpp"
+#else
+#include "..\include\cmp.hpp"
+#endif
+
+#include "check.hpp"
+
+namespace {
+
+	template<typename T> const char* type_name();
+	template<> const char* type_name<std::int32_t>() { return "int32"; }
+	template<> const char* type_name<std::uint32_t>() { return "uint32"; }
+	template<> const char* type_name<std::int64_t>() { return "int64"; }
+	template<> const char* type_name<float>() { return "float"; }
+	template<> const char* type_name<double>() { return "double"; }
+
+	// The bin of "value" by a chain of ifs over the bounds
+	template<typename T>
+	std::size_t expected_bin(const std::vector<T>& bounds, const std::vector<char>& strict, T value) {
+		std::size_t bin = 0;
+		for (; bin < bounds.size(); ++bin) {
+			if (strict[bin] ? !(value >= bounds[bin]) : !(value > bounds[bin]))
+				break;
+		}
+		return bin;
+	}
+
+	template<typename T>
+	std::vector<T> special_values() {
+		using limits = std::numeric_limits<T>;
+		std::vector<T> values = { limits::lowest(), T(limits::lowest() + 1), T(0), T(1), T(limits::max() - 1), limits::max() };
+		if constexpr (std::is_signed<T>::value)
+			values.push_back(T(-1));
+		if constexpr (std::is_floating_point<T>::value)
+			values.insert(values.end(), { -limits::infinity(), limits::infinity(), T(-0.0), limits::denorm_min(), T(0.5) });
+		return values;
+	}
+
+	// Special values and small ones, so a value often equals a bound
+	template<typename T>
+	T pick(std::mt19937_64& engine, const std::vector<T>& special) {
+		if (engine() % 4 == 0)
+			return special[engine() % special.size()];
+		return T(int(engine() % 33) - (std::is_signed<T>::value ? 16 : 0));
+	}
+
+	// Sorted bounds, and their links which keep the chain true
+	template<typename T>
+	void make_bounds(std::mt19937_64& engine, const std::vector<T>& special, std::size_t count,
+		std::vector<T>& bounds, std::vector<char>& strict) {
+		bounds.resize(count);
+		strict.resize(count);
+		for (auto& bound : bounds)
+			bound = pick(engine, special);
+		std::sort(bounds.begin(), bounds.end());
+		for (std::size_t inx = 0; inx < count; ++inx)
+			strict[inx] = (inx == 0 || bounds[inx - 1] < bounds[inx]) && engine() % 2;
+	}
+
+	// The thresholds "Buckets" compares, padded for the kernels
+	template<typename T>
+	std::size_t thresholds(const std::vector<T>& bounds, const std::vector<char>& strict, std::vector<T>& padded) {
+		padded.clear();
+		for (std::size_t inx = 0; inx < bounds.size(); ++inx) {
+			T threshold = bounds[inx];
+			if (!strict[inx] && !cmp::next_value(threshold))
+				break;
+			padded.push_back(threshold);
+		}
+		const std::size_t size = padded.size();
+		if (size)
+			padded.resize((size + 15) / 16 * 16, padded.back());
+		return size;
+	}
+
+	template<typename T>
+	void check_kernels(const std::vector<T>& bounds, const std::vector<char>& strict, const std::vector<T>& data,
+		const std::vector<std::size_t>& expected) {
+		std::vector<T> padded;
+		const std::size_t size = thresholds(bounds, strict, padded);
+		if (!size)
+			return;
+		const auto check = [&](cmp::Bucket_kernel<T> kernel, const char* name) {
+			if (!kernel)
+				return;
+			std::vector<std::size_t> counts(bounds.size() + 1);
+			kernel(padded.data(), size, padded.size(), data.data(), data.size(), counts.data());
+			check::expect(counts == expected, "%s, %s, %zu bounds", name, type_name<T>(), bounds.size());
+		};
+		check(&cmp::simd::bucket_scalar<T>, "scalar bucket kernel");
+#if defined(CMP_SIMD_X86)
+		using namespace cmp::simd;
+		const int level = isa_level();
+		if (level >= 1)
+			check(sse2_bucket<T>(std::integral_constant<bool, Sse2_lanes<T>::enabled>{}), "SSE2 bucket kernel");
+		if (level >= 2)
+			check(avx2_bucket<T>(std::integral_constant<bool, Avx2_lanes<T>::enabled>{}), "AVX2 bucket kernel");
+		if (level >= 3)
+			check(avx512_bucket<T>(std::integral_constant<bool, Avx512_lanes<T>::enabled>{}), "AVX-512 bucket kernel");
+#endif
+	}
+
+	template<typename T>
+	void check_type(std::mt19937_64& engine) {
+		std::vector<T> special = special_values<T>();
+		std::vector<T> data(1000);
+		for (auto& value : data)
+			value = pick(engine, special);
+		data.insert(data.end(), special.begin(), special.end());
+		if constexpr (std::is_floating_point<T>::value)
+			data.insert(data.end(), { std::numeric_limits<T>::quiet_NaN(), -std::numeric_limits<T>::quiet_NaN() });
+
+		std::vector<T> bounds;
+		std::vector<char> strict;
+		for (std::size_t count = 0; count <= 80; ++count) {
+			for (int round = 0; round < 8; ++round) {
+				make_bounds(engine, special, count, bounds, strict);
+				bool links[80];
+				std::copy(strict.begin(), strict.end(), links);
+				const cmp::Buckets<T> buckets(bounds.data(), links, count);
+				check::expect(buckets.bins() == count + 1, "bins, %s, %zu bounds", type_name<T>(), count);
+
+				std::vector<std::size_t> expected(count + 1);
+				for (T value : data) {
+					const std::size_t bin = expected_bin(bounds, strict, value);
+					++expected[bin];
+					check::expect(buckets(value) == bin, "bin of %g, %s, %zu bounds: %zu, expected %zu", double(value),
+						type_name<T>(), count, buckets(value), bin);
+				}
+				check::expect(buckets.histogram(data) == expected, "histogram, %s, %zu bounds", type_name<T>(), count);
+				if (count <= 64)
+					check_kernels(bounds, strict, data, expected);
+			}
+		}
+	}
+
+	// Bins of chains, as documented by "Buckets"
+	void check_chains() {
+		const auto bins = cmp::buckets(cmp::chain << 0 < 10 <= 20 < 30);
+		const int values[] = { -1, 0, 9, 10, 19, 20, 21, 29, 30, 31 };
+		const std::size_t expected[] = { 0, 1, 1, 2, 2, 2, 3, 3, 4, 4 };
+		for (std::size_t inx = 0; inx < sizeof(values) / sizeof(values[0]); ++inx)
+			check::expect(bins(values[inx]) == expected[inx], "chain bin of %d: %zu, expected %zu", values[inx],
+				bins(values[inx]), expected[inx]);
+
+		// Nothing passes "<= INT32_MAX", the last bin stays empty
+		const auto top = cmp::buckets(cmp::chain << 0 <= INT32_MAX);
+		check::expect(top(INT32_MAX) == 1 && top(0) == 1 && top(-1) == 0, "chain of <= INT32_MAX");
+		check::expect(top.histogram(std::vector<int>{ -1, 0, INT32_MAX }) == std::vector<std::size_t>{ 1, 2, 0 },
+			"histogram of <= INT32_MAX");
+
+		// NaN passes no bound, +infinity passes all but "<= +infinity"
+		const double inf = std::numeric_limits<double>::infinity();
+		const auto wide = cmp::buckets(cmp::chain << -inf <= 0.0 < inf <= inf);
+		check::expect(wide(std::nan("")) == 0 && wide(-inf) == 1 && wide(-0.0) == 1 && wide(1.0) == 2 && wide(inf) == 3,
+			"chain of -inf <= 0.0 < inf <= inf");
+	}
+
+}
+
+int main() {
+	std::mt19937_64 engine(13);
+	check_type<std::int32_t>(engine);
+	check_type<std::uint32_t>(engine);
+	check_type<std::int64_t>(engine);
+	check_type<float>(engine);
+	check_type<double>(engine);
+	check_chains();
+#if defined(CMP_SIMD_X86)
+	std::printf("bucket kernels checked up to level %d (0: none, 1: SSE2, 2: AVX2, 3: AVX-512)\n", cmp::simd::isa_level());
+#endif
+	return check::report("buckets");
+}
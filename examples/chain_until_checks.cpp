@@ -0,0 +1,182 @@
+//============================================================================
+// Name        : chain_until_checks.cpp
+// Author      : Rahman Salim Zengin
+// Version     :
+// Copyright   : rsz@gufatek.com
+// Description : "chain_until" of a non-transitive type and its parallel stop
+//============================================================================
+
+/*
+ * "Hand" defines only "<" and "<=", rock < paper < scissors < rock, so it is
+ * checked by all pairs and a descending link pattern is compared as "b < a".
+ * Every array of up to 7 hands is checked against a plain loop over the pairs.
+ * "parallel_until" is checked to return the lowest failing link, and to stop the
+ * chunks past a failure found in the first one. An exception of "parallel_until"
+ * or "parallel_tasks" work, thrown by the calling thread or by a worker, must
+ * reach the caller after the workers are joined, instead of terminating.
+ */
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstddef>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#ifdef __GNUG__
+#include "../include/cmp.hpp"
+#else
+#include "..\include\cmp.hpp"
+#endif
+
+#include "check.hpp"
+
+namespace {
+
+	// 0 rock, 1 paper, 2 scissors, each one beaten by the next
+	struct Hand {
+		int shape = 0;
+	};
+
+	bool operator<(Hand lhs, Hand rhs) { return (lhs.shape + 1) % 3 == rhs.shape; }
+	bool operator<=(Hand lhs, Hand rhs) { return lhs.shape == rhs.shape || lhs < rhs; }
+
+}
+
+template<>
+struct cmp::is_transitive<Hand> : std::false_type {};
+
+namespace {
+
+	void expect(const char* name, std::size_t result, std::size_t expected) {
+		check::expect(result == expected, "%s: %zu, expected %zu", name, result, expected);
+	}
+
+	// The first element failing with any of the preceding ones, the links repeat "strict"
+	std::size_t all_pairs_until(const std::vector<Hand>& hands, const std::vector<bool>& strict, bool descending) {
+		for (std::size_t rhs = 1; rhs < hands.size(); ++rhs) {
+			bool strict_pair = false;
+			for (std::size_t lhs = rhs; lhs-- > 0;) {
+				strict_pair = strict_pair || strict[lhs % strict.size()];
+				const Hand& low = descending ? hands[rhs] : hands[lhs];
+				const Hand& high = descending ? hands[lhs] : hands[rhs];
+				if (!(strict_pair ? low < high : low <= high))
+					return rhs;
+			}
+		}
+		return hands.size();
+	}
+
+	void check_hands() {
+		using cmp::Link;
+		for (std::size_t size = 0; size <= 7; ++size) {
+			std::size_t codes = 1;
+			for (std::size_t inx = 0; inx < size; ++inx)
+				codes *= 3;
+			for (std::size_t code = 0; code < codes; ++code) {
+				std::vector<Hand> hands(size);
+				for (std::size_t inx = 0, rest = code; inx < size; ++inx, rest /= 3)
+					hands[inx].shape = int(rest % 3);
+				expect("strict", cmp::chain_until(hands, cmp::strict), all_pairs_until(hands, { true }, false));
+				expect("non_strict", cmp::chain_until(hands, cmp::non_strict), all_pairs_until(hands, { false }, false));
+				expect("is_chain", cmp::is_chain(hands, cmp::strict), all_pairs_until(hands, { true }, false) == size);
+				expect("< <=", cmp::chain_until(hands, std::vector<Link>{ Link::LowerThan, Link::LowerThanEqual }),
+					all_pairs_until(hands, { true, false }, false));
+				expect("<= <= <", cmp::chain_until(hands, std::vector<Link>{ Link::LowerThanEqual, Link::LowerThanEqual, Link::LowerThan }),
+					all_pairs_until(hands, { false, false, true }, false));
+				expect("> >=", cmp::chain_until(hands, std::vector<Link>{ Link::GreaterThan, Link::GreaterThanEqual }),
+					all_pairs_until(hands, { true, false }, true));
+			}
+		}
+	}
+
+	void check_parallel() {
+		constexpr std::size_t threads = 4;
+		constexpr std::size_t n = threads * 16 * cmp::until_step;
+		std::vector<int> values(n);
+		for (std::size_t inx = 0; inx < n; ++inx)
+			values[inx] = int(inx);
+		const auto serial = [&](std::size_t begin, std::size_t end) {
+			for (std::size_t inx = begin; inx < end; ++inx)
+				if (!(values[inx - 1] < values[inx]))
+					return inx;
+			return end;
+		};
+
+		// Failures at the ends of the chunks and of the steps, several at a time
+		const std::size_t chunk = (n - 1 + threads - 1) / threads;
+		const std::vector<std::vector<std::size_t>> cases = { {}, { 1 }, { 5 }, { n - 1 }, { chunk }, { chunk + 1 },
+			{ 1 + cmp::until_step }, { 3 * chunk + 7, chunk + 2 }, { n - 1, 2 * chunk, 1 + chunk } };
+		for (const auto& failing : cases) {
+			for (std::size_t inx : failing)
+				values[inx] = -1;
+			std::size_t expected = n;
+			for (std::size_t inx : failing)
+				expected = std::min(expected, inx);
+			for (std::size_t count = 1; count <= threads + 1; ++count)
+				expect("parallel_until", cmp::parallel_until(serial, n, count), expected);
+			for (std::size_t inx : failing)
+				values[inx] = int(inx);
+		}
+
+		// The steps of the other chunks start late, so the failure at 5 is found first
+		values[5] = -1;
+		std::atomic<std::size_t> checked{ 0 };
+		const auto delayed = [&](std::size_t begin, std::size_t end) {
+			if (begin >= chunk)
+				std::this_thread::sleep_for(std::chrono::milliseconds(20));
+			const std::size_t found = serial(begin, end);
+			checked += found - begin;
+			return found;
+		};
+		expect("parallel_until, stop", cmp::parallel_until(delayed, n, threads), 5);
+		check::expect(checked <= threads * cmp::until_step, "parallel_until checked %zu links past the failure",
+			std::size_t(checked));
+		values[5] = 5;
+	}
+
+	// "true" if "func" throws std::runtime_error
+	template<typename Func>
+	bool throws(const Func& func) {
+		try {
+			func();
+		}
+		catch (const std::runtime_error&) {
+			return true;
+		}
+		return false;
+	}
+
+	void check_exceptions() {
+		constexpr std::size_t threads = 4;
+		constexpr std::size_t n = threads * 4 * cmp::until_step;
+		const std::size_t chunk = (n - 1 + threads - 1) / threads;
+		// The first chunk is run by the calling thread, the others by the workers
+		for (std::size_t failing : { std::size_t(1), chunk + 1, 3 * chunk + 1 }) {
+			const auto until = [failing](std::size_t begin, std::size_t end) -> std::size_t {
+				if (begin <= failing && failing < end)
+					throw std::runtime_error("until");
+				return end;
+			};
+			check::expect(throws([&] { cmp::parallel_until(until, n, threads); }),
+				"parallel_until, a throw at %zu didn't reach the caller", failing);
+		}
+		for (std::size_t failing : { std::size_t(0), std::size_t(5), std::size_t(63) }) {
+			const auto task = [failing](std::size_t inx) {
+				if (inx == failing)
+					throw std::runtime_error("task");
+			};
+			check::expect(throws([&] { cmp::parallel_tasks(64, threads, task); }),
+				"parallel_tasks, a throw of task %zu didn't reach the caller", failing);
+		}
+	}
+
+}
+
+int main() {
+	check_hands();
+	check_parallel();
+	check_exceptions();
+	return check::report("chain_until");
+}
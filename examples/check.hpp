@@ -0,0 +1,60 @@
+//============================================================================
+// Name        : check.hpp
+// Author      : Rahman Salim Zengin
+// Version     :
+// Copyright   : rsz@gufatek.com
+// Description : Failure counting shared by the check programs
+//============================================================================
+
+/*
+ * Every "*_checks.cpp" program, "comparisons.cpp" and "copies.cpp" is built and
+ * run by run_checks.sh, which fails if any of them does:
+ *     g++ -std=c++17 -O2 -pthread <name>.cpp -o <name> && ./<name>
+ * The C++20 ones are built with the flags run_checks.sh names for them.
+ * A check counts its failures by "check::expect", which prints the first
+ * "check::printed" of them, and returns "check::report(name)" from main. It
+ * prints "<name> ok" and returns 0, or prints "<name> FAILED" and returns 1.
+ */
+
+#ifndef CMP_CHECK_HPP_
+#define CMP_CHECK_HPP_
+
+#include <cstdarg>
+#include <cstdio>
+
+namespace check {
+
+	inline int failures = 0;
+
+	// Failures past this many are counted without printing them
+	constexpr int printed = 20;
+
+	// Counts a failure unless "ok", printing "FAIL" and the formatted message
+#if defined(__GNUC__)
+	__attribute__((format(printf, 2, 3)))
+#endif
+	inline bool expect(bool ok, const char* format, ...) {
+		if (ok)
+			return true;
+		if (++failures <= printed) {
+			std::va_list args;
+			va_start(args, format);
+			std::printf("FAIL ");
+			std::vprintf(format, args);
+			std::printf("\n");
+			va_end(args);
+		}
+		return false;
+	}
+
+	// The exit status of main
+	inline int report(const char* name) {
+		if (failures > printed)
+			std::printf("%d more failures\n", failures - printed);
+		std::printf("%s %s\n", name, failures ? "FAILED" : "ok");
+		return failures ? 1 : 0;
+	}
+
+}
+
+#endif /* CMP_CHECK_HPP_ */
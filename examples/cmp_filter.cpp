@@ -0,0 +1,550 @@
+//============================================================================
+// Name        : cmp_filter.cpp
+// Author      : Rahman Salim Zengin
+// Version     :
+// Copyright   : rsz@gufatek.com
+// Description : Row filter of numeric files by a comparison chain expression
+//============================================================================
+
+/*
+ * Build: g++ -std=c++17 -O2 -pthread cmp_filter.cpp -o cmp-filter
+ *
+ * Usage: cmp-filter [-b COLUMNS] [-c] [-j THREADS] [-n] [-t] EXPRESSION FILE
+ *        cmp-filter -g text|binary ROWS COLUMNS FILE
+ *
+ *   EXPRESSION  a chain of numbers and columns, columns are numbered from 1,
+ *               e.g. '5 < $2 <= 15' or '0.4 < $1 <= $2 <= $3 < 0.6'
+ *   -b COLUMNS  FILE is binary, COLUMNS columns of native doubles one after the other
+ *   -c          prints the number of the matching rows instead of the rows
+ *   -j THREADS  worker threads, one per hardware thread by default
+ *   -n          naive evaluation by std::ifstream and "&&", for comparison
+ *   -t          prints the throughput to stderr
+ *   -g          generates a text or binary file of random values in [0, 100)
+ *
+ * A text file has a row per line, its fields are separated by any run of commas, spaces
+ * or tabs, so an empty field is skipped. A number may start with '+', "inf" and "nan"
+ * are not numbers, the same as the -n baseline reads them. A row missing a column of
+ * the expression, or not having a number there, is not matched and the number of such
+ * malformed rows is reported on stderr.
+ * The file is memory mapped (POSIX) and its chunks are filtered in parallel by a
+ * "cmp::Dynamic_chain", the lines are parsed by "std::from_chars" in place.
+ * Matching rows are written in file order, the lines of a text file as they are.
+ */
+
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#ifdef __GNUG__
+#include "../include/cmp.hpp"
+#else
+#include "..\include\cmp.hpp"
+#endif
+
+namespace {
+
+	using Clock = std::chrono::steady_clock;
+	using Operand = cmp::Dynamic_operand<double>;
+
+	constexpr std::size_t chunk_bytes = std::size_t(1) << 20; // Text chunk of a task, extended to the end of its last line
+	constexpr std::size_t chunk_rows = std::size_t(1) << 17; // Binary rows of a task
+	constexpr std::size_t block_rows = 64 * 32; // Rows of a "select_mask" call
+
+	struct Options {
+		std::string expression;
+		std::string path;
+		std::size_t binary_columns = 0; // Zero for a text file
+		std::size_t threads = std::max(1u, std::thread::hardware_concurrency());
+		bool count = false;
+		bool naive = false;
+		bool timing = false;
+		std::string generate; // "text" or "binary", empty unless generating
+		std::size_t generate_rows = 0;
+		std::size_t generate_columns = 0;
+	};
+
+	struct Expression {
+		std::vector<Operand> operands;
+		std::vector<cmp::Link> links;
+	};
+
+	// e.g. "5 < $2 <= 15", the operators of "cmp::Link" between numbers and columns
+	Expression parse_expression(std::string_view text) {
+		Expression expression;
+		const char* const last = text.data() + text.size();
+		const char* pos = text.data();
+		for (bool operand = true;; operand = !operand) {
+			while (pos != last && std::isspace(static_cast<unsigned char>(*pos)))
+				++pos;
+			if (pos == last) {
+				if (operand)
+					throw std::invalid_argument("The expression ends without an operand");
+				break;
+			}
+			if (operand && *pos == '$') {
+				std::size_t column = 0;
+				const auto result = std::from_chars(pos + 1, last, column);
+				if (result.ec != std::errc() || column == 0)
+					throw std::invalid_argument("Invalid column at \"" + std::string(pos, last) + "\"");
+				expression.operands.push_back(Operand::placeholder(column - 1));
+				pos = result.ptr;
+			}
+			else if (operand) {
+				double value = 0;
+				const auto result = std::from_chars(pos, last, value);
+				if (result.ec != std::errc())
+					throw std::invalid_argument("Invalid number at \"" + std::string(pos, last) + "\"");
+				expression.operands.push_back(value);
+				pos = result.ptr;
+			}
+			else {
+				if (*pos != '<' && *pos != '>')
+					throw std::invalid_argument("Expected '<', '<=', '>' or '>=' at \"" + std::string(pos, last) + "\"");
+				const bool lower = *pos == '<';
+				const bool equal = pos + 1 != last && pos[1] == '=';
+				expression.links.push_back(lower ?
+					(equal ? cmp::Link::LowerThanEqual : cmp::Link::LowerThan) :
+					(equal ? cmp::Link::GreaterThanEqual : cmp::Link::GreaterThan));
+				pos += equal ? 2 : 1;
+			}
+		}
+		if (expression.links.empty())
+			throw std::invalid_argument("The expression has no comparison");
+		return expression;
+	}
+
+	// Read only mapping of a whole file
+	class Mapped_file {
+	public:
+		explicit Mapped_file(const std::string& path) {
+			const int fd = ::open(path.c_str(), O_RDONLY);
+			if (fd < 0)
+				throw std::system_error(errno, std::generic_category(), path);
+			struct stat status;
+			if (::fstat(fd, &status) != 0) {
+				const int error = errno;
+				::close(fd);
+				throw std::system_error(error, std::generic_category(), path);
+			}
+			size_ = std::size_t(status.st_size);
+			if (size_) {
+				void* data = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+				if (data == MAP_FAILED) {
+					const int error = errno;
+					::close(fd);
+					throw std::system_error(error, std::generic_category(), path);
+				}
+				::madvise(data, size_, MADV_SEQUENTIAL);
+				data_ = static_cast<const char*>(data);
+			}
+			::close(fd);
+		}
+
+		~Mapped_file() {
+			if (data_)
+				::munmap(const_cast<char*>(data_), size_);
+		}
+
+		Mapped_file(const Mapped_file&) = delete;
+		Mapped_file& operator=(const Mapped_file&) = delete;
+
+		const char* data() const { return data_; }
+		std::size_t size() const { return size_; }
+
+	private:
+		const char* data_ = nullptr;
+		std::size_t size_ = 0;
+	};
+
+	struct Chunk_result {
+		std::size_t count = 0;
+		std::size_t malformed = 0;
+		std::string output;
+	};
+
+	// Matching and malformed rows of a file
+	struct Totals {
+		std::size_t count = 0;
+		std::size_t malformed = 0;
+	};
+
+	/*
+	 * Runs "task(chunk, result)" over the chunks in parallel, a wave of a few chunks
+	 * per thread at a time. The output of each wave is written in chunk order.
+	 */
+	template<typename Task>
+	Totals run_chunks(std::size_t chunks, const Options& options, const Task& task) {
+		const std::size_t wave = options.threads * 4;
+		std::vector<Chunk_result> results(std::min(wave, chunks));
+		Totals totals;
+		for (std::size_t first = 0; first < chunks; first += wave) {
+			const std::size_t size = std::min(wave, chunks - first);
+			cmp::parallel_tasks(size, options.threads, [&](std::size_t inx) {
+				results[inx].count = 0;
+				results[inx].malformed = 0;
+				results[inx].output.clear();
+				task(first + inx, results[inx]);
+			});
+			for (std::size_t inx = 0; inx < size; ++inx) {
+				totals.count += results[inx].count;
+				totals.malformed += results[inx].malformed;
+				std::fwrite(results[inx].output.data(), 1, results[inx].output.size(), stdout);
+			}
+		}
+		return totals;
+	}
+
+	bool is_blank(char ch) { return ch == ' ' || ch == '\t' || ch == '\r'; }
+
+	bool is_separator(char ch) { return ch == ',' || is_blank(ch); }
+
+	/*
+	 * Fields "0 .. columns - 1" of a line, read as the baseline reads them by "operator>>".
+	 * Returns false and sets NaN for all of them if one is missing or not a number.
+	 */
+	bool parse_row(const char* first, const char* last, double* const* values, std::size_t row, std::size_t columns) {
+		for (std::size_t column = 0; column < columns; ++column) {
+			while (first != last && is_separator(*first))
+				++first;
+			if (last - first > 1 && *first == '+' && first[1] != '-')
+				++first;
+			// "std::from_chars" reads "inf" and "nan" as well, the baseline doesn't
+			const bool number = first != last && !std::isalpha(static_cast<unsigned char>(*first));
+			const auto result = number ? std::from_chars(first, last, values[column][row]) :
+				std::from_chars_result{ first, std::errc::invalid_argument };
+			first = result.ptr;
+			if (result.ec != std::errc() || (first != last && !is_separator(*first))) {
+				for (column = 0; column < columns; ++column)
+					values[column][row] = std::numeric_limits<double>::quiet_NaN();
+				return false;
+			}
+		}
+		return true;
+	}
+
+	// Starts of the text chunks, each one after a newline, and the end of the file
+	std::vector<std::size_t> text_chunks(const char* data, std::size_t size) {
+		std::vector<std::size_t> starts{ 0 };
+		for (std::size_t pos = chunk_bytes; pos < size;) {
+			const void* newline = std::memchr(data + pos - 1, '\n', size - pos + 1);
+			if (!newline)
+				break;
+			const std::size_t start = std::size_t(static_cast<const char*>(newline) - data) + 1;
+			if (start >= size)
+				break;
+			starts.push_back(start);
+			pos = start + chunk_bytes;
+		}
+		starts.push_back(size);
+		return starts;
+	}
+
+	/*
+	 * A block of lines is parsed into the columns of the expression, the values are
+	 * NaN for a malformed row so none of its links hold. "select_mask" of the chain
+	 * evaluates the whole block, a link at a time.
+	 */
+	Totals filter_text(const Mapped_file& file, const cmp::Dynamic_chain<double>& chain, const Options& options) {
+		const char* const data = file.data();
+		const std::vector<std::size_t> starts = text_chunks(data, file.size());
+		const std::size_t columns = chain.arity();
+		return run_chunks(starts.size() - 1, options, [&](std::size_t chunk, Chunk_result& result) {
+			std::vector<double> storage(std::max<std::size_t>(1, columns) * block_rows);
+			std::vector<double*> values(std::max<std::size_t>(1, columns));
+			for (std::size_t column = 0; column < values.size(); ++column)
+				values[column] = storage.data() + column * block_rows;
+			std::vector<std::string_view> lines(block_rows);
+			std::uint64_t masks[block_rows / 64];
+
+			const char* const end = data + starts[chunk + 1];
+			for (const char* line = data + starts[chunk]; line < end;) {
+				std::size_t rows = 0;
+				for (; rows < block_rows && line < end; ++rows) {
+					const void* newline = std::memchr(line, '\n', std::size_t(end - line));
+					const char* line_end = newline ? static_cast<const char*>(newline) : end;
+					result.malformed += !parse_row(line, line_end, values.data(), rows, columns);
+					lines[rows] = std::string_view(line, std::size_t(line_end - line));
+					line = line_end + 1;
+				}
+				chain.select_mask(values.data(), rows, masks);
+				for (std::size_t word = 0; word < (rows + 63) / 64; ++word) {
+					result.count += cmp::popcount64(masks[word]);
+					if (options.count)
+						continue;
+					for (std::uint64_t bits = masks[word]; bits; bits &= bits - 1) {
+						result.output += lines[word * 64 + cmp::ctz64(bits)];
+						result.output += '\n';
+					}
+				}
+			}
+		});
+	}
+
+	// The shortest text which reads back as the same value
+	void append_value(std::string& output, double value) {
+		char text[32];
+		const auto result = std::to_chars(text, text + sizeof(text), value);
+		output.append(text, result.ptr);
+	}
+
+	void append_row(std::string& output, const double* const* columns, std::size_t row, std::size_t count) {
+		for (std::size_t column = 0; column < count; ++column) {
+			if (column)
+				output += ',';
+			append_value(output, columns[column][row]);
+		}
+		output += '\n';
+	}
+
+	// The columns are read in place from the mapping, "select_mask" is given pointers into them
+	Totals filter_binary(const Mapped_file& file, const cmp::Dynamic_chain<double>& chain, const Options& options) {
+		const std::size_t count = options.binary_columns;
+		if (file.size() % (count * sizeof(double)) != 0)
+			throw std::invalid_argument("The size of the file is not a multiple of the row size");
+		if (chain.arity() > count)
+			throw std::invalid_argument("The expression refers to a column beyond the file");
+		const std::size_t rows = file.size() / (count * sizeof(double));
+		const double* const data = reinterpret_cast<const double*>(file.data());
+		return run_chunks((rows + chunk_rows - 1) / chunk_rows, options, [&](std::size_t chunk, Chunk_result& result) {
+			std::vector<const double*> columns(count);
+			std::uint64_t masks[block_rows / 64];
+			const std::size_t end = std::min(rows, (chunk + 1) * chunk_rows);
+			for (std::size_t base = chunk * chunk_rows; base < end; base += block_rows) {
+				const std::size_t size = std::min(block_rows, end - base);
+				for (std::size_t column = 0; column < count; ++column)
+					columns[column] = data + column * rows + base;
+				chain.select_mask(columns.data(), size, masks);
+				for (std::size_t word = 0; word < (size + 63) / 64; ++word) {
+					result.count += cmp::popcount64(masks[word]);
+					if (options.count)
+						continue;
+					for (std::uint64_t bits = masks[word]; bits; bits &= bits - 1)
+						append_row(result.output, columns.data(), word * 64 + cmp::ctz64(bits), count);
+				}
+			}
+		});
+	}
+
+	bool link_holds(cmp::Link link, double lhs, double rhs) {
+		switch (link) {
+		case cmp::Link::LowerThan: return lhs < rhs;
+		case cmp::Link::LowerThanEqual: return lhs <= rhs;
+		case cmp::Link::GreaterThan: return lhs > rhs;
+		default: return lhs >= rhs;
+		}
+	}
+
+	// The links checked one after the other by "&&", the operands are "values" or constants
+	bool naive_match(const Expression& expression, const std::vector<double>& values) {
+		const auto operand = [&](std::size_t inx) {
+			const Operand& op = expression.operands[inx];
+			return op.arg == Operand::constant ? op.value : values[op.arg];
+		};
+		bool match = true;
+		for (std::size_t inx = 0; inx < expression.links.size(); ++inx)
+			match = match && link_holds(expression.links[inx], operand(inx), operand(inx + 1));
+		return match;
+	}
+
+	// The baseline, std::getline and a std::istringstream per line, a number is followed by a blank
+	Totals naive_text(const Expression& expression, std::size_t columns, const Options& options) {
+		std::ifstream in(options.path);
+		if (!in)
+			throw std::system_error(errno, std::generic_category(), options.path);
+		std::vector<double> values(columns);
+		std::string line;
+		std::string fields;
+		Totals totals;
+		while (std::getline(in, line)) {
+			fields = line;
+			std::replace(fields.begin(), fields.end(), ',', ' ');
+			std::istringstream stream(fields);
+			bool valid = true;
+			for (double& value : values) {
+				valid = valid && bool(stream >> value);
+				const int next = valid ? stream.peek() : EOF;
+				valid = valid && (next == EOF || std::isspace(next));
+			}
+			totals.malformed += !valid;
+			if (valid && naive_match(expression, values)) {
+				++totals.count;
+				if (!options.count)
+					std::cout << line << '\n';
+			}
+		}
+		return totals;
+	}
+
+	// The baseline, the columns read by std::ifstream and each row checked by "&&"
+	Totals naive_binary(const Expression& expression, const Options& options) {
+		std::ifstream in(options.path, std::ios::binary | std::ios::ate);
+		if (!in)
+			throw std::system_error(errno, std::generic_category(), options.path);
+		const std::size_t count = options.binary_columns;
+		const std::size_t rows = std::size_t(in.tellg()) / (count * sizeof(double));
+		in.seekg(0);
+		std::vector<std::vector<double>> columns(count, std::vector<double>(rows));
+		for (auto& column : columns)
+			in.read(reinterpret_cast<char*>(column.data()), std::streamsize(rows * sizeof(double)));
+		std::vector<double> values(count);
+		std::string line;
+		Totals totals;
+		for (std::size_t row = 0; row < rows; ++row) {
+			for (std::size_t column = 0; column < count; ++column)
+				values[column] = columns[column][row];
+			if (naive_match(expression, values)) {
+				++totals.count;
+				if (!options.count) {
+					line.clear();
+					for (std::size_t column = 0; column < count; ++column) {
+						if (column)
+							line += ',';
+						append_value(line, values[column]);
+					}
+					std::cout << line << '\n';
+				}
+			}
+		}
+		return totals;
+	}
+
+	void generate(const Options& options) {
+		std::mt19937_64 engine(42);
+		std::uniform_real_distribution<double> value(0, 100);
+		std::FILE* out = std::fopen(options.path.c_str(), "wb");
+		if (!out)
+			throw std::system_error(errno, std::generic_category(), options.path);
+		if (options.generate == "binary") {
+			std::vector<double> column(options.generate_rows);
+			for (std::size_t inx = 0; inx < options.generate_columns; ++inx) {
+				for (double& x : column)
+					x = value(engine);
+				std::fwrite(column.data(), sizeof(double), column.size(), out);
+			}
+		}
+		else {
+			for (std::size_t row = 0; row < options.generate_rows; ++row)
+				for (std::size_t column = 0; column < options.generate_columns; ++column)
+					std::fprintf(out, "%.2f%c", value(engine), column + 1 < options.generate_columns ? ',' : '\n');
+		}
+		std::fclose(out);
+	}
+
+	std::size_t parse_size(const char* text, const char* what) {
+		std::size_t value = 0;
+		const char* last = text + std::strlen(text);
+		const auto result = std::from_chars(text, last, value);
+		if (result.ec != std::errc() || result.ptr != last || value == 0)
+			throw std::invalid_argument(std::string("Invalid ") + what + " \"" + text + "\"");
+		return value;
+	}
+
+	Options parse_options(int argc, char* argv[]) {
+		Options options;
+		std::vector<std::string> positional;
+		for (int inx = 1; inx < argc; ++inx) {
+			const std::string arg = argv[inx];
+			const auto next = [&](const char* what) {
+				if (inx + 1 == argc)
+					throw std::invalid_argument(arg + " requires " + what);
+				return argv[++inx];
+			};
+			if (arg == "-b")
+				options.binary_columns = parse_size(next("the number of columns"), "number of columns");
+			else if (arg == "-c")
+				options.count = true;
+			else if (arg == "-j")
+				options.threads = parse_size(next("the number of threads"), "number of threads");
+			else if (arg == "-n")
+				options.naive = true;
+			else if (arg == "-t")
+				options.timing = true;
+			else if (arg == "-g") {
+				options.generate = next("text or binary");
+				if (options.generate != "text" && options.generate != "binary")
+					throw std::invalid_argument("-g requires text or binary");
+				options.generate_rows = parse_size(next("the number of rows"), "number of rows");
+				options.generate_columns = parse_size(next("the number of columns"), "number of columns");
+			}
+			else
+				positional.push_back(arg);
+		}
+		if (!options.generate.empty()) {
+			if (positional.size() != 1)
+				throw std::invalid_argument("Usage: cmp-filter -g text|binary ROWS COLUMNS FILE");
+			options.path = positional[0];
+		}
+		else {
+			if (positional.size() != 2)
+				throw std::invalid_argument("Usage: cmp-filter [-b COLUMNS] [-c] [-j THREADS] [-n] [-t] EXPRESSION FILE");
+			options.expression = positional[0];
+			options.path = positional[1];
+		}
+		return options;
+	}
+
+}
+
+int main(int argc, char* argv[]) {
+	try {
+		const Options options = parse_options(argc, argv);
+		if (!options.generate.empty()) {
+			generate(options);
+			return 0;
+		}
+
+		const Expression expression = parse_expression(options.expression);
+		const cmp::Dynamic_chain<double> chain(expression.operands, expression.links);
+
+		const auto start = Clock::now();
+		std::size_t bytes = 0;
+		Totals totals;
+		if (options.naive) {
+			totals = options.binary_columns ? naive_binary(expression, options) : naive_text(expression, chain.arity(), options);
+			std::ifstream in(options.path, std::ios::binary | std::ios::ate);
+			bytes = std::size_t(in.tellg());
+		}
+		else {
+			const Mapped_file file(options.path);
+			totals = options.binary_columns ? filter_binary(file, chain, options) : filter_text(file, chain, options);
+			bytes = file.size();
+		}
+		std::fflush(stdout);
+		std::cout.flush();
+		const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+		if (options.count)
+			std::printf("%zu\n", totals.count);
+		if (totals.malformed)
+			std::fprintf(stderr, "cmp-filter: %zu malformed rows are not matched\n", totals.malformed);
+		if (options.timing)
+			std::fprintf(stderr, "%zu rows of %.3f GB in %.3f s, %.2f GB/s\n", totals.count, double(bytes) / 1e9, seconds,
+				double(bytes) / 1e9 / seconds);
+		return 0;
+	}
+	catch (const std::exception& error) {
+		std::fprintf(stderr, "cmp-filter: %s\n", error.what());
+		return 2;
+	}
+}
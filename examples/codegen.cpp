@@ -0,0 +1,72 @@
+//============================================================================
+// Name        : codegen.cpp
+// Author      : Rahman Salim Zengin
+// Version     :
+// Copyright   : rsz@gufatek.com
+// Description : Reference functions for the machine code comparison
+//============================================================================
+
+/*
+ * Each "hand_<name>" function is the hand written form of a comparison.
+ * "codegen_parity.sh" compiles this file and fails if any "<engine>_<name>"
+ * function of the same name has more instructions than the hand written one.
+ * String comparisons are left to the benchmark, their code depends on how much
+ * of "char_traits" the compiler decides to inline rather than on the chain.
+ */
+
+#ifdef __GNUG__
+#include "../include/cmp.hpp"
+#else
+#include "..\include\cmp.hpp"
+#endif
+
+extern "C" {
+
+	// Numeric range
+	bool hand_range_int(int x) { return 5 < x && x <= 15; }
+	bool node_range_int(int x) { return cmp::chain_root << 5 < x <= 15; }
+	bool chain_range_int(int x) { return cmp::chain << 5 < x <= 15; }
+	bool pred_range_int(int x) {
+		static constexpr auto in_range = cmp::chain << 5 < cmp::_ <= 15;
+		return in_range(x);
+	}
+
+	// Descending numeric range
+	bool hand_descending_int(int x) { return 15 > x && x >= 5; }
+	bool node_descending_int(int x) { return cmp::chain_root >> 15 > x >= 5; }
+	bool chain_descending_int(int x) { return cmp::chain >> 15 > x >= 5; }
+	bool pred_descending_int(int x) {
+		static constexpr auto in_range = cmp::chain >> 15 > cmp::_ >= 5;
+		return in_range(x);
+	}
+
+	// Combined fractional range
+	bool hand_fraction(double a, double b, double c) { return 0.4 < a && a <= b && b <= c && c < 0.6; }
+	bool node_fraction(double a, double b, double c) { return cmp::chain_root << 0.4 < a <= b <= c < 0.6; }
+	bool chain_fraction(double a, double b, double c) { return cmp::chain << 0.4 < a <= b <= c < 0.6; }
+	bool pred_fraction(double a, double b, double c) {
+		static constexpr auto in_range = cmp::chain << 0.4 < cmp::arg<0> <= cmp::arg<1> <= cmp::arg<2> < 0.6;
+		return in_range(a, b, c);
+	}
+
+	// Chain of eight variables
+	bool hand_sorted8(int a, int b, int c, int d, int e, int f, int g, int h) {
+		return a < b && b < c && c < d && d < e && e < f && f < g && g < h;
+	}
+	bool node_sorted8(int a, int b, int c, int d, int e, int f, int g, int h) {
+		return cmp::chain_root << a < b < c < d < e < f < g < h;
+	}
+	bool chain_sorted8(int a, int b, int c, int d, int e, int f, int g, int h) {
+		return cmp::chain << a < b < c < d < e < f < g < h;
+	}
+
+	// Branchless evaluation against the hand written non-short-circuit form
+	bool hand_branchless(int a, int b, int c, int d) { return (a < b) & (b <= c) & (c < d); }
+	bool node_branchless(int a, int b, int c, int d) { return cmp::branchless_root << a < b <= c < d; }
+	bool chain_branchless(int a, int b, int c, int d) { return cmp::branchless_chain << a < b <= c < d; }
+	bool pred_branchless(int a, int b, int c, int d) {
+		static constexpr auto sorted = cmp::branchless_chain << cmp::arg<0> < cmp::arg<1> <= cmp::arg<2> < cmp::arg<3>;
+		return sorted(a, b, c, d);
+	}
+
+}
@@ -0,0 +1,67 @@
+#!/bin/sh
+#============================================================================
+# Name        : codegen_parity.sh
+# Description : Machine code comparison of the chains and the hand written forms
+#============================================================================
+#
+# Compiles codegen.cpp to assembly and counts the instructions of each function.
+# Fails if a "<engine>_<name>" function has more instructions than "hand_<name>".
+# Also fails if anything of "cmp::instrument" is emitted without CMP_INSTRUMENT,
+# and checks with CMP_INSTRUMENT (C++20) that it would have been detected.
+#
+# Usage: codegen_parity.sh [compiler...]    (default: c++)
+#        CXXFLAGS="-march=native" codegen_parity.sh g++ clang++
+
+cd "$(dirname "$0")" || exit 1
+compilers=${*:-c++}
+standards="c++17 c++20"
+levels="-O2 -O3"
+asm=$(mktemp) || exit 1
+trap 'rm -f "$asm"' EXIT
+
+status=0
+for cxx in $compilers; do
+	for std in $standards; do
+		for level in $levels; do
+			if ! $cxx -std=$std $level $CXXFLAGS -fno-asynchronous-unwind-tables -S -o "$asm" codegen.cpp; then
+				echo "FAIL $cxx -std=$std $level: compilation failed"
+				status=1
+				continue
+			fi
+			if grep -q instrument "$asm"; then
+				echo "FAIL $cxx -std=$std $level: instrumentation emitted without CMP_INSTRUMENT"
+				status=1
+			fi
+			# "name count" of each function, instructions are the indented lines other than directives
+			counts=$(awk '
+				/^[A-Za-z_][A-Za-z0-9_]*:/ { name = substr($1, 1, length($1) - 1); next }
+				/^\t\.size/ { if (name in count) print name, count[name]; name = ""; next }
+				name != "" && /^\t[a-z]/ { ++count[name] }
+			' "$asm")
+			result=$(echo "$counts" | awk -v setup="$cxx -std=$std $level" '
+				{ count[$1] = $2 }
+				END {
+					failed = 0
+					for (name in count) {
+						if (name !~ /^[a-z]+_/ || name ~ /^hand_/)
+							continue
+						ref = "hand_" substr(name, index(name, "_") + 1)
+						if (!(ref in count))
+							continue
+						verdict = count[name] <= count[ref] ? "ok  " : "FAIL"
+						if (verdict == "FAIL")
+							failed = 1
+						printf "%s %s %-24s %4d vs %4d\n", verdict, setup, name, count[name], count[ref]
+					}
+					exit failed
+				}')
+			[ $? -ne 0 ] && status=1
+			echo "$result" | sort -k5
+		done
+	done
+	if ! $cxx -std=c++20 -O2 $CXXFLAGS -DCMP_INSTRUMENT -S -o "$asm" codegen.cpp || ! grep -q instrument "$asm"; then
+		echo "FAIL $cxx -std=c++20 -DCMP_INSTRUMENT: no instrumentation emitted"
+		status=1
+	fi
+done
+exit $status
@@ -0,0 +1,109 @@
+//============================================================================
+// Name        : comparisons.cpp
+// Author      : Rahman Salim Zengin
+// Version     :
+// Copyright   : rsz@gufatek.com
+// Description : Comparison counts of the evaluation strategies
+//============================================================================
+
+/*
+ * A chain of N ascending operands of a transitive type takes N - 1 comparisons
+ * ("Adjacent"), of a non-transitive type N * (N - 1) / 2 ("AllPairs"), in both
+ * engines. A chain failing at its first link takes a single comparison.
+ */
+
+#include <array>
+#include <cstdio>
+#include <cstddef>
+#include <utility>
+
+#ifdef __GNUG__
+#include "../include/cmp.hpp"
+#else
+#include "..\include\cmp.hpp"
+#endif
+
+#include "check.hpp"
+
+namespace {
+
+	std::size_t comparisons = 0;
+
+	// Counts every comparison, "Transitive" selects the strategy
+	template<bool Transitive>
+	struct Counted {
+		int value;
+	};
+
+	template<bool Transitive>
+	bool operator<(const Counted<Transitive>& lhs, const Counted<Transitive>& rhs) {
+		++comparisons;
+		return lhs.value < rhs.value;
+	}
+
+	template<bool Transitive>
+	bool operator<=(const Counted<Transitive>& lhs, const Counted<Transitive>& rhs) {
+		++comparisons;
+		return lhs.value <= rhs.value;
+	}
+
+}
+
+template<>
+struct cmp::is_transitive<Counted<false>> : std::false_type {};
+
+namespace {
+
+	void expect(const char* engine, const char* strategy, std::size_t length, std::size_t count, std::size_t expected) {
+		check::expect(count == expected, "%-10s %-9s length %2zu: %zu comparisons, expected %zu", engine, strategy, length,
+			count, expected);
+	}
+
+	template<typename Root, typename T, std::size_t... Inx>
+	bool evaluate(Root root, const T* v, std::index_sequence<Inx...>) {
+		return bool(((root << v[0]) < ... < v[Inx + 1]));
+	}
+
+	template<bool Transitive, std::size_t Length>
+	void count_length() {
+		const auto links = std::make_index_sequence<Length - 1>{};
+		const char* strategy = Transitive ? "adjacent" : "all-pairs";
+		const std::size_t holds = Transitive ? Length - 1 : Length * (Length - 1) / 2;
+		std::array<Counted<Transitive>, Length> ascending;
+		for (std::size_t inx = 0; inx < Length; ++inx)
+			ascending[inx].value = int(inx);
+		std::array<Counted<Transitive>, Length> failing = ascending;
+
+		comparisons = 0;
+		if (!evaluate(cmp::chain_root, ascending.data(), links))
+			expect("chain_root", strategy, Length, 1, 0);
+		expect("chain_root", strategy, Length, comparisons, holds);
+		comparisons = 0;
+		if (!evaluate(cmp::chain, ascending.data(), links))
+			expect("chain", strategy, Length, 1, 0);
+		expect("chain", strategy, Length, comparisons, holds);
+
+		// The first link fails, nothing after it is compared
+		failing[0].value = int(Length);
+		comparisons = 0;
+		if (evaluate(cmp::chain_root, failing.data(), links))
+			expect("chain_root", strategy, Length, 1, 0);
+		expect("chain_root", strategy, Length, comparisons, 1);
+		comparisons = 0;
+		if (evaluate(cmp::chain, failing.data(), links))
+			expect("chain", strategy, Length, 1, 0);
+		expect("chain", strategy, Length, comparisons, 1);
+	}
+
+	template<std::size_t... Length>
+	void count_lengths(std::index_sequence<Length...>) {
+		(count_length<true, Length + 2>(), ...);
+		(count_length<false, Length + 2>(), ...);
+	}
+
+}
+
+int main() {
+	count_lengths(std::make_index_sequence<63>{}); // Lengths 2 to 64
+	return check::report("comparisons");
+}
@@ -0,0 +1,165 @@
+//============================================================================
+// Name        : compile_time.cpp
+// Author      : Rahman Salim Zengin
+// Version     :
+// Copyright   : rsz@gufatek.com
+// Description : Compile time and compiler memory of long chains
+//============================================================================
+
+/*
+ * Build: g++ -std=c++17 -O2 compile_time.cpp -o compile_time    (POSIX only)
+ * Run:   ./compile_time [node] [conductor] [length...]
+ *        e.g. CXX=clang++ CXXFLAGS="-std=c++20 -O2" ./compile_time node 128 256
+ *
+ * Generates a translation unit with one chain of "length" int operands for each
+ * engine ("node" is cmp::chain_root, "conductor" is cmp::chain) and compiles it
+ * with $CXX $CXXFLAGS (default: c++ -std=c++17 -O1). Prints the wall time and
+ * the peak resident memory of the compiler. The default lengths are
+ * 2, 8, 32, 128 and 256. A compilation taking more than $CMP_TIME_LIMIT seconds
+ * of CPU time (default: 600) is stopped and reported as "-".
+ * The header is looked up in $CMP_INCLUDE (default: ../include, relative to
+ * the examples directory the program is built in).
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace {
+
+	struct Engine {
+		const char* name;
+		const char* root;
+	};
+
+	const Engine engines[] = { { "node", "cmp::chain_root" }, { "conductor", "cmp::chain" } };
+
+	struct Result {
+		bool ok;
+		double seconds;
+		long peak_kb;
+	};
+
+	std::string environment(const char* name, const char* fallback) {
+		const char* value = std::getenv(name);
+		return value && *value ? value : fallback;
+	}
+
+	// Words of a command line, split at spaces
+	std::vector<std::string> words(const std::string& line) {
+		std::vector<std::string> result;
+		std::istringstream stream(line);
+		for (std::string word; stream >> word;)
+			result.push_back(word);
+		return result;
+	}
+
+	void generate(const std::string& path, const Engine& engine, std::size_t length) {
+		std::ofstream out(path);
+		out << "#include \"cmp.hpp\"\n\nbool chain(const int* v) {\n\treturn " << engine.root << " << v[0]";
+		for (std::size_t inx = 1; inx < length; ++inx)
+			out << (inx % 2 ? " < v[" : " <= v[") << inx << ']';
+		out << ";\n}\n";
+	}
+
+	// Runs the compiler in a child process, "wait4" reports the peak memory of
+	// the driver and of the compiler proper it waited for
+	Result compile(const std::vector<std::string>& command, long time_limit) {
+		std::vector<char*> argv;
+		for (const auto& word : command)
+			argv.push_back(const_cast<char*>(word.c_str()));
+		argv.push_back(nullptr);
+
+		const auto start = std::chrono::steady_clock::now();
+		const pid_t pid = fork();
+		if (pid < 0)
+			return { false, 0, 0 };
+		if (pid == 0) {
+			const rlimit limit{ rlim_t(time_limit), rlim_t(time_limit) };
+			setrlimit(RLIMIT_CPU, &limit);
+			execvp(argv[0], argv.data());
+			_exit(127);
+		}
+		int status = 0;
+		rusage usage{};
+		if (wait4(pid, &status, 0, &usage) != pid)
+			return { false, 0, 0 };
+		const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		return { WIFEXITED(status) && WEXITSTATUS(status) == 0, seconds, usage.ru_maxrss };
+	}
+
+}
+
+int main(int argc, char* argv[]) {
+	std::vector<const Engine*> selected;
+	std::vector<std::size_t> lengths;
+	for (int arg = 1; arg < argc; ++arg) {
+		bool found = false;
+		for (const auto& engine : engines)
+			if (std::strcmp(argv[arg], engine.name) == 0) {
+				selected.push_back(&engine);
+				found = true;
+			}
+		if (found)
+			continue;
+		const long length = std::strtol(argv[arg], nullptr, 10);
+		if (length < 2) {
+			std::fprintf(stderr, "usage: %s [node] [conductor] [length...]    (length >= 2)\n", argv[0]);
+			return 2;
+		}
+		lengths.push_back(std::size_t(length));
+	}
+	if (selected.empty())
+		for (const auto& engine : engines)
+			selected.push_back(&engine);
+	if (lengths.empty())
+		lengths = { 2, 8, 32, 128, 256 };
+
+	const std::string compiler = environment("CXX", "c++");
+	const std::string flags = environment("CXXFLAGS", "-std=c++17 -O1");
+	const long time_limit = std::strtol(environment("CMP_TIME_LIMIT", "600").c_str(), nullptr, 10);
+
+	char directory[] = "/tmp/cmp_compile_time.XXXXXX";
+	if (!mkdtemp(directory)) {
+		std::perror("mkdtemp");
+		return 1;
+	}
+	const std::string source = std::string(directory) + "/chain.cpp";
+	const std::string object = std::string(directory) + "/chain.o";
+	const std::string file = __FILE__;
+	const std::string include = environment("CMP_INCLUDE", (file.substr(0, file.find_last_of('/') + 1) + "../include").c_str());
+
+	std::vector<std::string> command = words(compiler);
+	for (const auto& word : words(flags))
+		command.push_back(word);
+	for (const char* word : { "-I", include.c_str(), "-c", source.c_str(), "-o", object.c_str() })
+		command.push_back(word);
+
+	std::printf("%s %s\n%-10s %6s %10s %12s\n", compiler.c_str(), flags.c_str(), "engine", "length", "seconds", "peak MB");
+	int status = 0;
+	for (const Engine* engine : selected)
+		for (std::size_t length : lengths) {
+			generate(source, *engine, length);
+			const Result result = compile(command, time_limit);
+			if (result.ok)
+				std::printf("%-10s %6zu %10.2f %12.1f\n", engine->name, length, result.seconds, double(result.peak_kb) / 1024);
+			else {
+				std::printf("%-10s %6zu %10s %12s\n", engine->name, length, "-", "-");
+				status = 1;
+			}
+			std::fflush(stdout);
+		}
+	std::remove(source.c_str());
+	std::remove(object.c_str());
+	rmdir(directory);
+	return status;
+}
@@ -0,0 +1,185 @@
+//============================================================================
+// Name        : constant_checks.cpp
+// Author      : Rahman Salim Zengin
+// Version     :
+// Copyright   : rsz@gufatek.com
+// Description : Contradicting constant chains and the intervals of cmp::range
+//============================================================================
+
+/*
+ * POSIX only.
+ *
+ * A chain of "std::integral_constant" operands which contradict is folded to
+ * "Strategy::AlwaysFalse" by both engines, checked by static_asserts. The program
+ * compiles itself with $CXX (default: c++) to check that such a chain warns and
+ * a consistent one doesn't, and that cmp::range rejects "-5 < _ <= 10u"; it is
+ * looked up as __FILE__, or as $CMP_SOURCE.
+ * "cmp::range" is checked against its predicate for all of the bounds and values
+ * of 8 bit types, and for the extreme bounds of the wider types, by all four
+ * combinations of "<" and "<=".
+ */
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <limits>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#ifdef __GNUG__
+#include "../include/cmp.hpp"
+#else
+#include "..\include\cmp.hpp"
+#endif
+
+#include "check.hpp"
+
+namespace {
+
+	using zero = std::integral_constant<int, 0>;
+	using five = std::integral_constant<int, 5>;
+
+	template<typename Chain>
+	constexpr bool folds = std::is_same<typename Chain::strategy, cmp::Strategy::AlwaysFalse>::value;
+
+	constexpr int y = 3;
+
+	// "5 < y < 0" contradicts, "0 <= y <= 5", "0 <= y < 0" and "5 > y > 0" don't, "0 < y <= 0" does
+	static_assert(folds<decltype(cmp::chain_root << five{} < y < zero{})>, "node of 5 < y < 0");
+	static_assert(folds<decltype(cmp::chain << five{} < y < zero{})>, "conductor of 5 < y < 0");
+	static_assert(!folds<decltype(cmp::chain_root << zero{} <= y <= five{})>, "node of 0 <= y <= 5");
+	static_assert(!folds<decltype(cmp::chain << zero{} <= y <= five{})>, "conductor of 0 <= y <= 5");
+	static_assert(!folds<decltype(cmp::chain_root << zero{} <= zero{} <= y)>, "node of 0 <= 0 <= y");
+	static_assert(!folds<decltype(cmp::chain << zero{} <= zero{} <= y)>, "conductor of 0 <= 0 <= y");
+	static_assert(folds<decltype(cmp::chain_root << zero{} < y <= zero{})>, "node of 0 < y <= 0");
+	static_assert(folds<decltype(cmp::chain << zero{} < y <= zero{})>, "conductor of 0 < y <= 0");
+	static_assert(folds<decltype(cmp::chain_root << zero{} <= y <= zero{} < zero{})>, "node of 0 <= y <= 0 < 0");
+	static_assert(folds<decltype(cmp::chain << zero{} <= y <= zero{} < zero{})>, "conductor of 0 <= y <= 0 < 0");
+	static_assert(!folds<decltype(cmp::chain_root >> five{} > y > zero{})>, "node of 5 > y > 0");
+	static_assert(!folds<decltype(cmp::chain >> five{} > y > zero{})>, "conductor of 5 > y > 0");
+	static_assert(folds<decltype(cmp::chain_root >> zero{} > y > five{})>, "node of 0 > y > 5");
+	static_assert(folds<decltype(cmp::chain >> zero{} > y > five{})>, "conductor of 0 > y > 5");
+
+	// A consistent constant chain is evaluated at compile time as well
+	static_assert(cmp::chain_root << zero{} <= y < five{}, "node of 0 <= 3 < 5");
+	static_assert(cmp::chain << zero{} <= y < five{}, "conductor of 0 <= 3 < 5");
+	static_assert(!(cmp::chain << zero{} <= 7 < five{}), "conductor of 0 <= 7 < 5");
+
+	// "cmp::range" folds its interval at compile time
+	static_assert(cmp::range(cmp::chain << 1 < cmp::_ <= 5)(5), "1 < 5 <= 5");
+	static_assert(!cmp::range(cmp::chain << 1 < cmp::_ <= 5)(1), "1 < 1 <= 5");
+	static_assert(cmp::range(cmp::chain << 1 < cmp::_ < 1).empty(), "1 < _ < 1");
+	static_assert(!cmp::range(cmp::chain << INT32_MIN <= cmp::_ <= INT32_MAX).empty(), "INT32_MIN <= _ <= INT32_MAX");
+	static_assert(cmp::range(cmp::chain << INT32_MAX < cmp::_).empty(), "INT32_MAX < _");
+
+	// Bounds of mixed signedness are only accepted if their common type is signed
+	static_assert(!cmp::is_exact_range<int, unsigned>::value, "-5 < _ <= 10u");
+	static_assert(!cmp::is_exact_range<unsigned, std::int64_t, std::uint64_t>::value, "5u < _ <= -10 in uint64");
+	static_assert(cmp::is_exact_range<std::int64_t, unsigned>::value, "-5 < _ <= 10u in int64");
+	static_assert(cmp::range(cmp::chain << std::int64_t(-5) < cmp::_ <= 10u)(0), "-5 < 0 <= 10u");
+	static_assert(!cmp::range(cmp::chain << std::int64_t(-5) < cmp::_ <= 10u)(-5), "-5 < -5 <= 10u");
+
+	// cmp::range of each strictness against the predicate, for every value of "values"
+	template<typename T>
+	void check_range(T lo, T hi, const std::vector<T>& values) {
+		const auto check = [&](const auto& pred) {
+			const auto range = cmp::range(pred);
+			bool any = false;
+			for (T value : values) {
+				check::expect(range(value) == pred(value), "range differs from its predicate, bounds %s %s, value %s",
+					std::to_string(lo).c_str(), std::to_string(hi).c_str(), std::to_string(value).c_str());
+				any = any || pred(value);
+			}
+			// A range holding a value isn't empty
+			check::expect(!any || !range.empty(), "range of a value is empty");
+		};
+		check(cmp::chain << lo < cmp::_ < hi);
+		check(cmp::chain << lo < cmp::_ <= hi);
+		check(cmp::chain << lo <= cmp::_ < hi);
+		check(cmp::chain << lo <= cmp::_ <= hi);
+		check(cmp::chain << cmp::_ < hi);
+		check(cmp::chain << cmp::_ <= hi);
+		check(cmp::chain << lo < cmp::_);
+		check(cmp::chain << lo <= cmp::_);
+	}
+
+	// Every bound and value of an 8 bit type
+	template<typename T>
+	void check_all() {
+		std::vector<T> values;
+		for (int value = std::numeric_limits<T>::lowest(); value <= std::numeric_limits<T>::max(); ++value)
+			values.push_back(T(value));
+		for (T lo : values)
+			for (T hi : values)
+				check_range(lo, hi, values);
+	}
+
+	// The extremes of a type and the values next to them, each one as a bound
+	template<typename T>
+	void check_extremes() {
+		const T lowest = std::numeric_limits<T>::lowest(), max = std::numeric_limits<T>::max();
+		std::vector<T> values = { lowest, T(lowest + 1), T(lowest + 2), T(max / 2), T(max - 2), T(max - 1), max };
+		if (std::is_signed<T>::value)
+			values.insert(values.end(), { T(-2), T(-1), T(0), T(1), T(2) });
+		for (T lo : values)
+			for (T hi : values)
+				check_range(lo, hi, values);
+	}
+
+	// "CMP_DIAGNOSTIC" compiled by itself prints "message", or not, as "expected" says
+	void check_diagnostic(const char* name, int diagnostic, bool expected,
+		const char* message = "Always false comparison chain", bool compiles = true) {
+		const char* cxx = std::getenv("CXX");
+		const char* source = std::getenv("CMP_SOURCE");
+		const std::string command = std::string(cxx && *cxx ? cxx : "c++") + " -std=c++17 -fsyntax-only -DCMP_DIAGNOSTIC=" +
+			std::to_string(diagnostic) + " " + (source && *source ? source : __FILE__) + " 2>&1";
+		std::FILE* pipe = ::popen(command.c_str(), "r");
+		if (!pipe) {
+			check::expect(false, "the compiler can't be started");
+			return;
+		}
+		std::string output;
+		char buffer[4096];
+		for (std::size_t size; (size = std::fread(buffer, 1, sizeof(buffer), pipe)) > 0;)
+			output.append(buffer, size);
+		const int status = ::pclose(pipe);
+		const bool warned = output.find(message) != std::string::npos;
+		if ((status == 0) != compiles || warned != expected) {
+			std::printf("%s", output.c_str());
+			check::expect(false, "%s", name);
+		}
+	}
+
+}
+
+#if defined(CMP_DIAGNOSTIC)
+// Compiled by "check_diagnostic", a chain evaluated at runtime
+int diagnostic(int x) {
+#if CMP_DIAGNOSTIC == 1
+	return cmp::chain_root << five{} < x < zero{};
+#elif CMP_DIAGNOSTIC == 2
+	return cmp::chain << five{} < x < zero{};
+#elif CMP_DIAGNOSTIC == 4
+	return cmp::range(cmp::chain << -5 < cmp::_ <= 10u)(x);
+#else
+	return (cmp::chain_root << zero{} <= x < five{}) + (cmp::chain << zero{} <= x < five{});
+#endif
+}
+#else
+int main() {
+	check_all<std::int8_t>();
+	check_all<std::uint8_t>();
+	check_extremes<int>();
+	check_extremes<unsigned>();
+	check_extremes<std::int64_t>();
+	check_extremes<std::uint64_t>();
+
+	check_diagnostic("node of 5 < x < 0 warns", 1, true);
+	check_diagnostic("conductor of 5 < x < 0 warns", 2, true);
+	check_diagnostic("0 <= x < 5 doesn't warn", 3, false);
+	check_diagnostic("range of -5 < _ <= 10u is rejected", 4, true, "Bounds of cmp::range are not exact", false);
+
+	return check::report("constants");
+}
+#endif
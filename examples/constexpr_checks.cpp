@@ -0,0 +1,109 @@
+//============================================================================
+// Name        : constexpr_checks.cpp
+// Author      : Rahman Salim Zengin
+// Version     :
+// Copyright   : rsz@gufatek.com
+// Description : Compile time checks of both engines
+//============================================================================
+
+/*
+ * Build: g++ -std=c++17 -c constexpr_checks.cpp
+ * Every check is a static_assert, the program compiles only if all of them hold.
+ */
+
+#ifdef __GNUG__
+#include "../include/cmp.hpp"
+#else
+#include "..\include\cmp.hpp"
+#endif
+
+namespace {
+
+	// A literal type, "Ordinal" is transitive and "Score" is not, so "Score"
+	// chains are evaluated by "AllPairs"
+	template<int Tag>
+	struct Literal {
+		int value;
+	};
+
+	template<int Tag>
+	constexpr bool operator<(Literal<Tag> lhs, Literal<Tag> rhs) { return lhs.value < rhs.value; }
+	template<int Tag>
+	constexpr bool operator<=(Literal<Tag> lhs, Literal<Tag> rhs) { return lhs.value <= rhs.value; }
+	template<int Tag>
+	constexpr bool operator>(Literal<Tag> lhs, Literal<Tag> rhs) { return lhs.value > rhs.value; }
+	template<int Tag>
+	constexpr bool operator>=(Literal<Tag> lhs, Literal<Tag> rhs) { return lhs.value >= rhs.value; }
+
+	using Ordinal = Literal<0>;
+	using Score = Literal<1>;
+
+}
+
+template<>
+struct cmp::is_transitive<Score> : std::false_type {};
+
+// "chain_root", "Adjacent"
+static_assert(cmp::chain_root << 1 < 2 <= 2 < 5, "Ascending");
+static_assert(!(cmp::chain_root << 1 < 2 <= 2 < 5 <= 7 < 6), "Last link fails");
+static_assert(!(cmp::chain_root << 3 < 2 < 5), "First link fails");
+static_assert(cmp::chain_root << -1 < 0.5 < 1u, "Mixed operand types");
+static_assert(cmp::chain_root << Ordinal{ 1 } < Ordinal{ 2 } <= Ordinal{ 2 }, "Literal operands");
+static_assert(!(cmp::chain_root << Ordinal{ 1 } < Ordinal{ 0 }), "Literal operands fail");
+
+// "chain", "Adjacent"
+static_assert(cmp::chain << 1 < 2 <= 2 < 5, "Ascending");
+static_assert(!(cmp::chain << 1 < 2 <= 2 < 5 <= 7 < 6), "Last link fails");
+static_assert(!(cmp::chain << 3 < 2 < 5), "First link fails");
+static_assert(cmp::chain << -1 < 0.5 < 1u, "Mixed operand types");
+static_assert(cmp::chain << Ordinal{ 1 } < Ordinal{ 2 } <= Ordinal{ 2 }, "Literal operands");
+static_assert(!(cmp::chain << Ordinal{ 1 } < Ordinal{ 0 }), "Literal operands fail");
+
+// "AllPairs"
+static_assert(cmp::chain_root << Score{ 1 } < Score{ 2 } <= Score{ 2 } < Score{ 5 }, "All pairs hold");
+static_assert(!(cmp::chain_root << Score{ 1 } < Score{ 3 } < Score{ 2 }), "Adjacent pair fails");
+static_assert(cmp::chain << Score{ 1 } < Score{ 2 } <= Score{ 2 } < Score{ 5 }, "All pairs hold");
+static_assert(!(cmp::chain << Score{ 1 } < Score{ 3 } < Score{ 2 }), "Adjacent pair fails");
+
+// Descending
+static_assert(cmp::chain_root >> 7 > 5 >= 5 > 2, "Descending");
+static_assert(!(cmp::chain_root >> 7 > 5 >= 6 > 2), "Descending fails");
+static_assert(cmp::chain_root >> Score{ 7 } > Score{ 5 } >= Score{ 5 }, "Descending all pairs");
+static_assert(!(cmp::chain_root >> Score{ 7 } > Score{ 8 }), "Descending all pairs fails");
+
+// Branchless
+static_assert(cmp::branchless_root << 1 < 2 <= 2 < 5, "Branchless root");
+static_assert(!(cmp::branchless_root << 1 < 2 <= 2 < 5 <= 7 < 6), "Branchless root fails");
+static_assert(cmp::branchless_root >> 7 > 5 >= 5 > 2, "Branchless descending");
+static_assert(cmp::branchless_chain << 1 < 2 <= 2 < 5, "Branchless chain");
+static_assert(!(cmp::branchless_chain << 3 < 2 < 5), "Branchless chain fails");
+
+// Predicates
+namespace {
+
+	constexpr auto in_range = cmp::chain << 5 < cmp::_ <= 15;
+	constexpr auto between = cmp::chain << cmp::arg<0> < cmp::arg<1> < cmp::arg<2>;
+	constexpr auto ordinal_range = cmp::chain << Ordinal{ 0 } <= cmp::_ < Ordinal{ 10 };
+	constexpr auto score_range = cmp::chain << Score{ 0 } <= cmp::_ < Score{ 10 };
+	constexpr auto descending_range = cmp::chain >> 15 > cmp::_ >= 5;
+	constexpr auto descending_between = cmp::arg<0> > cmp::arg<1> >= cmp::arg<2>;
+	constexpr auto descending_score = cmp::chain >> Score{ 10 } > cmp::_ >= Score{ 0 };
+
+}
+
+static_assert(in_range.size() == 3 && in_range.arity() == 1, "Predicate shape");
+static_assert(in_range(10) && in_range(15), "Predicate holds");
+static_assert(!in_range(5) && !in_range(16), "Predicate fails");
+static_assert(between.arity() == 3, "Indexed placeholders");
+static_assert(between(1, 2, 3) && !between(1, 3, 3), "Indexed placeholders");
+static_assert(ordinal_range(Ordinal{ 0 }) && !ordinal_range(Ordinal{ 10 }), "Literal predicate");
+static_assert(score_range(Score{ 9 }) && !score_range(Score{ -1 }), "All pairs predicate");
+static_assert(descending_range(5) && descending_range(14), "Descending predicate holds");
+static_assert(!descending_range(4) && !descending_range(15), "Descending predicate fails");
+static_assert(descending_between(3, 2, 2) && !descending_between(2, 2, 1), "Descending placeholders");
+static_assert((cmp::chain >> cmp::_ > 0)(1) && !(cmp::chain >> 0 >= cmp::_)(1), "Descending single link");
+static_assert(descending_score(Score{ 0 }) && !descending_score(Score{ 10 }), "Descending all pairs predicate");
+
+int main() {
+	return 0;
+}
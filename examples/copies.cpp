@@ -0,0 +1,128 @@
+//============================================================================
+// Name        : copies.cpp
+// Author      : Rahman Salim Zengin
+// Version     :
+// Copyright   : rsz@gufatek.com
+// Description : Operand copies and moves of the chain engines and predicates
+//============================================================================
+
+/*
+ * "chain_root" and "chain" refer to operands which aren't small trivially
+ * copyable values, so building and evaluating a chain copies and moves nothing.
+ * A predicate stores its operands. A bound following the placeholder is copied
+ * once if it is an lvalue, moved and never copied if it is an rvalue. The bounds
+ * preceding the placeholder are referred to by the chain until then, so each of
+ * them is copied once.
+ * A temporary "chain" Conductor moves its Reserves into the next one, a named
+ * one is copied and stays usable. A Reserve refers to a "Key", so both are
+ * trivially copied and moved.
+ */
+
+#include <cstdio>
+#include <cstddef>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#ifdef __GNUG__
+#include "../include/cmp.hpp"
+#else
+#include "..\include\cmp.hpp"
+#endif
+
+#include "check.hpp"
+
+namespace {
+
+	std::size_t copies = 0;
+	std::size_t moves = 0;
+
+	// A key which isn't trivially copyable, counting its copies and moves
+	struct Key {
+		std::string text;
+
+		explicit Key(const char* text) : text(text) {}
+		Key(const Key& other) : text(other.text) { ++copies; }
+		Key(Key&& other) noexcept : text(std::move(other.text)) { ++moves; }
+		Key& operator=(const Key& other) { text = other.text; ++copies; return *this; }
+		Key& operator=(Key&& other) noexcept { text = std::move(other.text); ++moves; return *this; }
+	};
+
+	bool operator<(const Key& lhs, const Key& rhs) { return lhs.text < rhs.text; }
+	bool operator<=(const Key& lhs, const Key& rhs) { return lhs.text <= rhs.text; }
+	bool operator>(const Key& lhs, const Key& rhs) { return lhs.text > rhs.text; }
+	bool operator>=(const Key& lhs, const Key& rhs) { return lhs.text >= rhs.text; }
+
+	void reset() {
+		copies = 0;
+		moves = 0;
+	}
+
+	// "copies" must be "max_copies", "moves" at most "max_moves"
+	void expect(const char* name, bool result, bool expected, std::size_t max_copies, std::size_t max_moves) {
+		check::expect(result == expected && copies == max_copies && moves <= max_moves, "%-42s copies %zu, moves %zu", name,
+			copies, moves);
+	}
+
+	constexpr std::size_t any = std::size_t(-1);
+
+	using Prefix = decltype(cmp::chain << std::declval<const Key&>() < std::declval<const Key&>());
+	static_assert(std::is_trivially_copy_constructible<Prefix>::value && std::is_trivially_move_constructible<Prefix>::value,
+		"Conductor of references isn't trivially copied and moved");
+	static_assert(std::is_same<decltype(std::declval<Prefix>() < std::declval<const Key&>()),
+		decltype(std::declval<const Prefix&>() < std::declval<const Key&>())>::value, "Moved and copied Conductors differ");
+
+}
+
+int main() {
+	const Key a("a"), b("b"), c("c"), d("d"), e("e");
+
+	// The engines, through references only
+	reset();
+	expect("chain_root << lvalues", bool(cmp::chain_root << a < b <= c < d <= e), true, 0, 0);
+	reset();
+	expect("chain_root >> lvalues", bool(cmp::chain_root >> e > d >= c > b >= a), true, 0, 0);
+	reset();
+	expect("chain_root << lvalues, failing", bool(cmp::chain_root << a < c < b < d), false, 0, 0);
+	reset();
+	expect("branchless_root << lvalues", bool(cmp::branchless_root << a < b <= c < d <= e), true, 0, 0);
+	reset();
+	expect("chain << lvalues", bool(cmp::chain << a < b <= c < d <= e), true, 0, 0);
+	reset();
+	expect("chain >> lvalues", bool(cmp::chain >> e > d >= c > b >= a), true, 0, 0);
+	reset();
+	expect("chain << lvalues, failing", bool(cmp::chain << a < c < b < d), false, 0, 0);
+	reset();
+	expect("branchless_chain << lvalues", bool(cmp::branchless_chain << a < b <= c < d <= e), true, 0, 0);
+	// A temporary lives until the end of the full expression, it is referred to as well
+	reset();
+	expect("chain_root << rvalues", bool(cmp::chain_root << Key("a") < Key("b") < Key("c")), true, 0, 0);
+	reset();
+	expect("chain << rvalues", bool(cmp::chain << Key("a") < Key("b") < Key("c")), true, 0, 0);
+	// A named prefix is copied by each chain continuing it
+	reset();
+	const auto prefix = cmp::chain << a < b;
+	expect("chain, named prefix", bool(prefix <= c) && bool(prefix < d < e) && !bool(prefix < a), true, 0, 0);
+
+	// Predicates store their bounds, evaluation refers to the argument
+	reset();
+	const auto from_lvalues = cmp::chain << a < cmp::_ <= e;
+	expect("predicate of lvalue bounds", true, true, 2, any);
+	reset();
+	expect("predicate of lvalue bounds, call", from_lvalues(c), true, 0, 0);
+	reset();
+	const auto from_rvalues = cmp::chain << Key("a") < cmp::_ <= Key("e");
+	expect("predicate of rvalue bounds", true, true, 1, any);
+	reset();
+	expect("predicate of rvalue bounds, call", from_rvalues(Key("f")), false, 0, 0);
+	reset();
+	const auto leading = cmp::chain << cmp::_ < Key("c") <= Key("e");
+	expect("predicate of trailing rvalue bounds", true, true, 0, any);
+	reset();
+	expect("predicate of trailing rvalue bounds, call", leading(a), true, 0, 0);
+	reset();
+	const auto copied = from_lvalues;
+	expect("predicate copy", copied(d), true, 2, 0);
+
+	return check::report("copies");
+}
@@ -0,0 +1,224 @@
+//============================================================================
+// Name        : dynamic_chain_checks.cpp
+// Author      : Rahman Salim Zengin
+// Version     :
+// Copyright   : rsz@gufatek.com
+// Description : "Dynamic_chain" against the template chains
+//============================================================================
+
+/*
+ * Every pattern of "<" and "<=" links, and of ">" and ">=" links, of 2 to 5
+ * operands is evaluated by "chain_root", "chain" and a "Dynamic_chain" of
+ * constants, and of placeholders, for every combination of the special values
+ * of int and double: the limits, -0.0, the infinities and NaN. All of them must
+ * agree. "select_mask" and "select_count" of one and two placeholder columns
+ * are checked against the template chain of each element, at lengths which
+ * aren't multiples of 64. A chain of mixed directions, or of a link count other
+ * than one less than the operand count, must throw "std::invalid_argument".
+ */
+
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <limits>
+#include <random>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#ifdef __GNUG__
+#include "../include/cmp.hpp"
+#else
+#include "..\include\cmp.hpp"
+#endif
+
+#include "check.hpp"
+
+namespace {
+
+	using Lt = cmp::Operation::LowerThan;
+	using Le = cmp::Operation::LowerThanEqual;
+	using Gt = cmp::Operation::GreaterThan;
+	using Ge = cmp::Operation::GreaterThanEqual;
+
+	template<typename T> const char* type_name();
+	template<> const char* type_name<int>() { return "int"; }
+	template<> const char* type_name<double>() { return "double"; }
+
+	// The operator of a link, each bit of a pattern is set for a non-strict link
+	template<bool Descending, bool NonStrict>
+	using op_t = std::conditional_t<Descending, std::conditional_t<NonStrict, Ge, Gt>, std::conditional_t<NonStrict, Le, Lt>>;
+
+	// A "Node" is extended as an rvalue, as it is within a chain expression
+	template<typename Chain, typename T> auto link(Chain&& chain, Lt, const T& value) { return std::move(chain) < value; }
+	template<typename Chain, typename T> auto link(Chain&& chain, Le, const T& value) { return std::move(chain) <= value; }
+	template<typename Chain, typename T> auto link(Chain&& chain, Gt, const T& value) { return std::move(chain) > value; }
+	template<typename Chain, typename T> auto link(Chain&& chain, Ge, const T& value) { return std::move(chain) >= value; }
+
+	// The template chain of "chain" followed by the links "Ops" to the values
+	template<typename Chain, typename T>
+	bool extend(Chain&& chain, const T*) {
+		return bool(chain);
+	}
+
+	template<typename Op, typename... Ops, typename Chain, typename T>
+	bool extend(Chain&& chain, const T* values) {
+		return extend<Ops...>(link(std::forward<Chain>(chain), Op{}, values[0]), values + 1);
+	}
+
+	template<bool Descending, typename Root, typename... Ops, typename T>
+	bool evaluate(const Root& root, const T* values) {
+		if constexpr (Descending)
+			return extend<Ops...>(root >> values[0], values + 1);
+		else
+			return extend<Ops...>(root << values[0], values + 1);
+	}
+
+	template<typename T>
+	std::vector<T> special_values() {
+		using limits = std::numeric_limits<T>;
+		if constexpr (std::is_floating_point<T>::value)
+			return { -limits::infinity(), limits::lowest(), T(-1), T(-0.0), T(0), T(1), limits::infinity(), limits::quiet_NaN() };
+		else
+			return { limits::lowest(), T(-1), T(0), T(1), limits::max() };
+	}
+
+	template<typename T>
+	std::vector<cmp::Dynamic_operand<T>> placeholders(std::size_t count) {
+		std::vector<cmp::Dynamic_operand<T>> operands;
+		for (std::size_t inx = 0; inx < count; ++inx)
+			operands.push_back(cmp::Dynamic_operand<T>::placeholder(inx));
+		return operands;
+	}
+
+	// Every combination of the special values as the operands of a pattern
+	template<typename T, bool Descending, std::size_t Mask, std::size_t... Inx>
+	void check_pattern(std::index_sequence<Inx...>) {
+		constexpr std::size_t size = sizeof...(Inx) + 1;
+		const std::vector<cmp::Link> links = { (Descending ? ((Mask >> Inx) & 1 ? cmp::Link::GreaterThanEqual : cmp::Link::GreaterThan) :
+			((Mask >> Inx) & 1 ? cmp::Link::LowerThanEqual : cmp::Link::LowerThan))... };
+		const cmp::Dynamic_chain<T> runtime(placeholders<T>(size), links);
+		const std::vector<T> special = special_values<T>();
+
+		T values[size];
+		std::size_t digits[size] = {};
+		for (bool more = true; more;) {
+			for (std::size_t inx = 0; inx < size; ++inx)
+				values[inx] = special[digits[inx]];
+			const bool node = evaluate<Descending, cmp::Chain_root<>, op_t<Descending, (Mask >> Inx) & 1>...>(cmp::chain_root, values);
+			const bool conductor = evaluate<Descending, cmp::Initiator<>, op_t<Descending, (Mask >> Inx) & 1>...>(cmp::chain, values);
+			const bool constants = cmp::dynamic_chain<T>(std::vector<cmp::Dynamic_operand<T>>(values, values + size), links)
+				.evaluate(nullptr);
+			const bool args = runtime.evaluate(values);
+			check::expect(node == conductor && constants == node && args == node,
+				"%s %s %zu operands from %g, links %zx: chain_root %d, chain %d, constants %d, placeholders %d",
+				type_name<T>(), Descending ? "descending" : "ascending", size, double(values[0]), Mask, int(node),
+				int(conductor), int(constants), int(args));
+			// The next combination
+			more = false;
+			for (std::size_t inx = 0; inx < size && !more; ++inx) {
+				more = ++digits[inx] < special.size();
+				if (!more)
+					digits[inx] = 0;
+			}
+		}
+	}
+
+	template<typename T, bool Descending, std::size_t Links, std::size_t... Mask>
+	void check_patterns(std::index_sequence<Mask...>) {
+		(check_pattern<T, Descending, Mask>(std::make_index_sequence<Links>{}), ...);
+	}
+
+	template<typename T, bool Descending>
+	void check_lengths() {
+		check_patterns<T, Descending, 1>(std::make_index_sequence<2>{});
+		check_patterns<T, Descending, 2>(std::make_index_sequence<4>{});
+		check_patterns<T, Descending, 3>(std::make_index_sequence<8>{});
+		check_patterns<T, Descending, 4>(std::make_index_sequence<16>{});
+	}
+
+	// Special values and small random ones, so an element often equals a bound
+	template<typename T>
+	std::vector<T> sample(std::mt19937_64& engine, std::size_t n) {
+		const std::vector<T> special = special_values<T>();
+		std::vector<T> values(n);
+		for (auto& value : values)
+			value = engine() % 4 == 0 ? special[engine() % special.size()] : T(int(engine() % 9) - 4);
+		return values;
+	}
+
+	// "lo op _ op hi" over a column, and "lo op _ op mid op _ op hi" over two columns
+	template<typename T, typename LowerOp, typename UpperOp>
+	void check_select(std::mt19937_64& engine, cmp::Link lower, cmp::Link upper) {
+		static const std::size_t lengths[] = { 0, 1, 5, 63, 64, 65, 127, 129, 1000, 64 * 32 - 1, 64 * 32 + 1, 64 * 70 + 13 };
+		const std::vector<T> a = sample<T>(engine, 64 * 70 + 13), b = sample<T>(engine, a.size());
+		const T* const columns[] = { a.data(), b.data() };
+		for (int round = 0; round < 6; ++round) {
+			const std::vector<T> bounds = sample<T>(engine, 3);
+			const T lo = bounds[0], mid = bounds[1], hi = bounds[2];
+			const auto one = cmp::dynamic_chain<T>({ lo, cmp::_, hi }, { lower, upper });
+			const auto two = cmp::dynamic_chain<T>({ lo, cmp::arg<0>, mid, cmp::arg<1>, hi }, { lower, upper, lower, upper });
+			for (std::size_t n : lengths) {
+				std::vector<std::uint64_t> expected_one((n + 63) / 64), expected_two((n + 63) / 64);
+				std::size_t count = 0;
+				for (std::size_t inx = 0; inx < n; ++inx) {
+					const T one_values[] = { lo, a[inx], hi };
+					const T two_values[] = { lo, a[inx], mid, b[inx], hi };
+					const bool holds = evaluate<false, cmp::Chain_root<>, LowerOp, UpperOp>(cmp::chain_root, one_values);
+					expected_one[inx / 64] |= std::uint64_t(holds) << (inx % 64);
+					count += holds;
+					expected_two[inx / 64] |= std::uint64_t(evaluate<false, cmp::Chain_root<>, LowerOp, UpperOp, LowerOp, UpperOp>(
+						cmp::chain_root, two_values)) << (inx % 64);
+				}
+				std::vector<std::uint64_t> mask((n + 63) / 64);
+				one.select_mask(a.data(), n, mask.data());
+				check::expect(mask == expected_one, "select_mask of one column, %s, length %zu", type_name<T>(), n);
+				check::expect(one.select_count(a.data(), n) == count, "select_count, %s, length %zu: %zu, expected %zu",
+					type_name<T>(), n, one.select_count(a.data(), n), count);
+				two.select_mask(columns, n, mask.data());
+				check::expect(mask == expected_two, "select_mask of two columns, %s, length %zu", type_name<T>(), n);
+			}
+		}
+	}
+
+	template<typename T>
+	void check_type(std::mt19937_64& engine) {
+		check_lengths<T, false>();
+		check_lengths<T, true>();
+		check_select<T, Lt, Lt>(engine, cmp::Link::LowerThan, cmp::Link::LowerThan);
+		check_select<T, Lt, Le>(engine, cmp::Link::LowerThan, cmp::Link::LowerThanEqual);
+		check_select<T, Le, Lt>(engine, cmp::Link::LowerThanEqual, cmp::Link::LowerThan);
+		check_select<T, Le, Le>(engine, cmp::Link::LowerThanEqual, cmp::Link::LowerThanEqual);
+	}
+
+	void expect_invalid(const char* name, const std::vector<cmp::Dynamic_operand<int>>& operands, const std::vector<cmp::Link>& links) {
+		bool thrown = false;
+		try {
+			cmp::dynamic_chain<int>(operands, links);
+		}
+		catch (const std::invalid_argument&) {
+			thrown = true;
+		}
+		check::expect(thrown, "%s doesn't throw std::invalid_argument", name);
+	}
+
+	void check_invalid() {
+		using cmp::Link;
+		expect_invalid("< >", { 1, cmp::_, 3 }, { Link::LowerThan, Link::GreaterThan });
+		expect_invalid(">= <=", { 3, cmp::_, 1 }, { Link::GreaterThanEqual, Link::LowerThanEqual });
+		expect_invalid("< < >=", { 1, 2, cmp::_, 0 }, { Link::LowerThan, Link::LowerThan, Link::GreaterThanEqual });
+		expect_invalid("3 operands, 1 link", { 1, cmp::_, 3 }, { Link::LowerThan });
+		expect_invalid("2 operands, 2 links", { 1, cmp::_ }, { Link::LowerThan, Link::LowerThan });
+		expect_invalid("no operands", {}, {});
+		expect_invalid("no operands, 1 link", {}, { Link::LowerThan });
+	}
+
+}
+
+int main() {
+	std::mt19937_64 engine(15);
+	check_type<int>(engine);
+	check_type<double>(engine);
+	check_invalid();
+	return check::report("dynamic_chain");
+}
@@ -0,0 +1,108 @@
+//============================================================================
+// Name        : equal_range_checks.cpp
+// Author      : Rahman Salim Zengin
+// Version     :
+// Copyright   : rsz@gufatek.com
+// Description : "equal_range" and "Eytzinger_index" against a linear filter
+//============================================================================
+
+/*
+ * The subrange of sorted data found by "cmp::equal_range" and by an
+ * "Eytzinger_index" must hold exactly the elements a linear filter by the
+ * predicate selects. Checked for every size up to 70 and for the sizes around
+ * powers of two, where the last level of the Eytzinger tree is nearly empty or
+ * full, over distinct keys and over runs of duplicate keys. Every bound below,
+ * within and above the data is checked by each of the forms "lo < _ < hi",
+ * "_ < hi" and "lo < _", with each "<" also as "<=".
+ */
+
+#include <cstdio>
+#include <cstddef>
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#ifdef __GNUG__
+#include "../include/cmp.hpp"
+#else
+#include "..\include\cmp.hpp"
+#endif
+
+#include "check.hpp"
+
+namespace {
+
+	template<typename T> const char* type_name();
+	template<> const char* type_name<int>() { return "int"; }
+	template<> const char* type_name<double>() { return "double"; }
+
+	template<typename T, typename Pred>
+	void check_pred(const std::vector<T>& sorted, const cmp::Eytzinger_index<T>& index, const Pred& pred,
+		const char* form, T lo, T hi) {
+		const std::size_t expected = std::size_t(std::count_if(sorted.begin(), sorted.end(), pred));
+		const auto check_range = [&](const auto& range, const char* search) {
+			bool all = true;
+			for (const T& x : range)
+				all = all && pred(x);
+			check::expect(range.size() == expected && all, "%s of %s %s, %zu elements, lo %g, hi %g: %zu, expected %zu",
+				search, type_name<T>(), form, sorted.size(), double(lo), double(hi), range.size(), expected);
+		};
+		check_range(cmp::equal_range(sorted, pred), "equal_range");
+		check_range(cmp::equal_range(sorted.begin(), sorted.end(), pred), "equal_range of iterators");
+		check_range(cmp::equal_range(index, pred), "Eytzinger_index");
+	}
+
+	template<typename T>
+	void check_data(const std::vector<T>& sorted) {
+		const auto index = cmp::eytzinger_index(sorted);
+		check::expect(index.size() == sorted.size(), "Eytzinger_index size of %zu elements", sorted.size());
+		std::vector<T> bounds = { T(-1) };
+		for (std::size_t inx = 0; inx < sorted.size(); inx += 1 + sorted.size() / 16)
+			bounds.push_back(sorted[inx]);
+		if (!sorted.empty())
+			bounds.insert(bounds.end(), { sorted.back(), T(sorted.back() + 1) });
+		for (T lo : bounds) {
+			for (T hi : bounds) {
+				check_pred(sorted, index, cmp::chain << lo < cmp::_ < hi, "lo < _ < hi", lo, hi);
+				check_pred(sorted, index, cmp::chain << lo < cmp::_ <= hi, "lo < _ <= hi", lo, hi);
+				check_pred(sorted, index, cmp::chain << lo <= cmp::_ < hi, "lo <= _ < hi", lo, hi);
+				check_pred(sorted, index, cmp::chain << lo <= cmp::_ <= hi, "lo <= _ <= hi", lo, hi);
+			}
+			check_pred(sorted, index, cmp::chain << cmp::_ < lo, "_ < hi", lo, lo);
+			check_pred(sorted, index, cmp::chain << cmp::_ <= lo, "_ <= hi", lo, lo);
+			check_pred(sorted, index, cmp::chain << lo < cmp::_, "lo < _", lo, lo);
+			check_pred(sorted, index, cmp::chain << lo <= cmp::_, "lo <= _", lo, lo);
+		}
+	}
+
+	template<typename T>
+	void check_type(std::mt19937_64& engine) {
+		std::vector<std::size_t> sizes;
+		for (std::size_t n = 0; n <= 70; ++n)
+			sizes.push_back(n);
+		for (std::size_t power = 128; power <= 4096; power *= 2)
+			sizes.insert(sizes.end(), { power - 2, power - 1, power, power + 1 });
+		for (std::size_t n : sizes) {
+			// Distinct keys, the even numbers, so a bound may fall between two of them
+			std::vector<T> distinct(n);
+			for (std::size_t inx = 0; inx < n; ++inx)
+				distinct[inx] = T(2 * inx);
+			check_data(distinct);
+			// Runs of duplicates, and a single repeated key
+			std::vector<T> runs(n);
+			for (auto& key : runs)
+				key = T(engine() % (n / 4 + 1));
+			std::sort(runs.begin(), runs.end());
+			check_data(runs);
+			check_data(std::vector<T>(n, T(3)));
+		}
+	}
+
+}
+
+int main() {
+	std::mt19937_64 engine(18);
+	check_type<int>(engine);
+	check_type<double>(engine);
+	return check::report("equal_range");
+}
@@ -0,0 +1,240 @@
+//============================================================================
+// Name        : instrument_checks.cpp
+// Author      : Rahman Salim Zengin
+// Version     :
+// Copyright   : rsz@gufatek.com
+// Description : The counts of "cmp::instrument" against a model of the chains
+//============================================================================
+
+/*
+ * C++20 with CMP_INSTRUMENT only, run_checks.sh builds it with
+ * -std=c++20 -DCMP_INSTRUMENT.
+ * Chains of "chain", "chain_root" and "branchless_chain", each at a call site
+ * of its own, are evaluated for random rows by the main thread and by a second
+ * thread. The calls, the true results, the comparisons and the link each false
+ * result failed at, merged per site, must equal the counts of a model of the
+ * evaluation, while the second thread still runs and after it finished. A
+ * constexpr function evaluated at compile time isn't counted, only its calls
+ * at run time are. "report" and "report_json" must print those counts in their
+ * fields for each site.
+ */
+
+#include <cstdio>
+#include <cstddef>
+#include <array>
+#include <atomic>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef __GNUG__
+#include "../include/cmp.hpp"
+#else
+#include "..\include\cmp.hpp"
+#endif
+
+#include "check.hpp"
+
+#if !defined(CMP_INSTRUMENT)
+#error "instrument_checks.cpp requires -std=c++20 -DCMP_INSTRUMENT"
+#endif
+
+namespace {
+
+	using Row = std::array<int, 4>;
+
+	// Each chain on the line after its "line" constant
+	constexpr unsigned conductor_line = __LINE__ + 1;
+	bool conductor(const Row& r) { return cmp::chain << r[0] < r[1] <= r[2] < r[3]; }
+	constexpr unsigned node_line = __LINE__ + 1;
+	bool node(const Row& r) { return cmp::chain_root >> r[0] > r[1] >= r[2] > r[3]; }
+	constexpr unsigned branchless_line = __LINE__ + 1;
+	bool branchless(const Row& r) { return cmp::branchless_chain << r[0] < r[1] < r[2] < r[3]; }
+	constexpr unsigned constant_line = __LINE__ + 1;
+	constexpr bool constant(int a, int b, int c) { return cmp::chain_root << a < b <= c; }
+
+	// Evaluated at compile time, not counted
+	static_assert(constant(1, 2, 2) && !constant(2, 1, 3), "");
+	constexpr bool folded = constant(0, 1, 2);
+	static_assert(folded, "");
+
+	// The expected counts of a site
+	struct Model {
+		std::uint64_t calls = 0;
+		std::uint64_t holds = 0;
+		std::uint64_t comparisons = 0;
+		std::array<std::uint64_t, cmp::instrument::max_links> fails{};
+
+		// "holds" of each link, short-circuit stops at the first failing link
+		template<std::size_t Links>
+		void add(const std::array<bool, Links>& links, bool short_circuit) {
+			++calls;
+			std::size_t failed = links.size();
+			for (std::size_t inx = 0; inx < links.size() && failed == links.size(); ++inx)
+				if (!links[inx])
+					failed = inx;
+			comparisons += short_circuit ? std::min(failed + 1, links.size()) : links.size();
+			if (failed == links.size())
+				++holds;
+			else
+				++fails[failed];
+		}
+
+		void merge(const Model& other) {
+			calls += other.calls;
+			holds += other.holds;
+			comparisons += other.comparisons;
+			for (std::size_t inx = 0; inx < fails.size(); ++inx)
+				fails[inx] += other.fails[inx];
+		}
+	};
+
+	struct Models {
+		Model conductor, node, branchless, constant;
+
+		void merge(const Models& other) {
+			conductor.merge(other.conductor);
+			node.merge(other.node);
+			branchless.merge(other.branchless);
+			constant.merge(other.constant);
+		}
+	};
+
+	// Evaluates "count" random rows at each site, and the model of them
+	Models evaluate(unsigned seed, std::size_t count) {
+		std::mt19937_64 engine(seed);
+		Models models;
+		std::size_t wrong = 0;
+		for (std::size_t call = 0; call < count; ++call) {
+			Row r;
+			for (int& value : r)
+				value = int(engine() % 4);
+			const std::array<bool, 3> ascending = { r[0] < r[1], r[1] <= r[2], r[2] < r[3] };
+			const std::array<bool, 3> descending = { r[0] > r[1], r[1] >= r[2], r[2] > r[3] };
+			const std::array<bool, 3> strict = { r[0] < r[1], r[1] < r[2], r[2] < r[3] };
+			const std::array<bool, 2> two = { r[0] < r[1], r[1] <= r[2] };
+			wrong += conductor(r) != (ascending[0] && ascending[1] && ascending[2]);
+			wrong += node(r) != (descending[0] && descending[1] && descending[2]);
+			wrong += branchless(r) != (strict[0] && strict[1] && strict[2]);
+			models.conductor.add(ascending, true);
+			models.node.add(descending, true);
+			models.branchless.add(strict, false);
+			// The constexpr function called at run time for some of the rows
+			if (call % 3 == 0) {
+				wrong += constant(r[0], r[1], r[2]) != (two[0] && two[1]);
+				models.constant.add(two, true);
+			}
+		}
+		check::expect(wrong == 0, "seed %u: %zu wrong results", seed, wrong);
+		return models;
+	}
+
+	const cmp::instrument::Site_stats* find(const std::vector<cmp::instrument::Site_stats>& sites, unsigned line) {
+		for (const auto& stats : sites)
+			if (stats.line == line && stats.file == __FILE__)
+				return &stats;
+		return nullptr;
+	}
+
+	void check_site(const std::vector<cmp::instrument::Site_stats>& sites, const char* name, unsigned line,
+		const Model& model, const char* when) {
+		const cmp::instrument::Site_stats* stats = find(sites, line);
+		if (model.calls == 0) {
+			check::expect(stats == nullptr, "%s, %s: a site at line %u without any call", name, when, line);
+			return;
+		}
+		if (!check::expect(stats != nullptr, "%s, %s: no site at line %u", name, when, line))
+			return;
+		check::expect(stats->calls == model.calls, "%s, %s: calls %llu, expected %llu", name, when,
+			(unsigned long long)stats->calls, (unsigned long long)model.calls);
+		check::expect(stats->holds == model.holds, "%s, %s: true %llu, expected %llu", name, when,
+			(unsigned long long)stats->holds, (unsigned long long)model.holds);
+		check::expect(stats->comparisons == model.comparisons, "%s, %s: comparisons %llu, expected %llu", name, when,
+			(unsigned long long)stats->comparisons, (unsigned long long)model.comparisons);
+		for (std::size_t inx = 0; inx < model.fails.size(); ++inx)
+			check::expect(stats->fails[inx] == model.fails[inx], "%s, %s: fails[%zu] %llu, expected %llu", name, when, inx,
+				(unsigned long long)stats->fails[inx], (unsigned long long)model.fails[inx]);
+	}
+
+	void check_sites(const Models& models, const char* when) {
+		const auto sites = cmp::instrument::snapshot();
+		check_site(sites, "chain", conductor_line, models.conductor, when);
+		check_site(sites, "chain_root", node_line, models.node, when);
+		check_site(sites, "branchless_chain", branchless_line, models.branchless, when);
+		check_site(sites, "constexpr function", constant_line, models.constant, when);
+	}
+
+	bool contains(const std::string& text, const std::string& part) {
+		return text.find(part) != std::string::npos;
+	}
+
+	// The line of "report" and the object of "report_json" of a site
+	void check_reports(const char* name, unsigned line, const Model& model) {
+		std::ostringstream text, json;
+		cmp::instrument::report(text);
+		cmp::instrument::report_json(json);
+
+		std::ostringstream fields;
+		fields << " calls=" << model.calls << " true=" << model.holds << " comparisons=" <<
+			double(model.comparisons) / double(model.calls) << " fails=[" << model.fails[0] << ' ' << model.fails[1] << ' ' <<
+			model.fails[2] << "]\n";
+		const std::string location = std::string(__FILE__) + ':' + std::to_string(line) + ':';
+		const std::size_t begin = text.str().find(location);
+		const std::string report_line = begin == std::string::npos ? std::string() :
+			text.str().substr(begin, text.str().find('\n', begin) + 1 - begin);
+		check::expect(contains(report_line, fields.str()), "report of %s: \"%s\", expected the fields \"%s\"", name,
+			report_line.c_str(), fields.str().c_str());
+
+		std::ostringstream object;
+		object << "{\"file\": \"" << __FILE__ << "\", \"line\": " << line << ", \"column\": ";
+		std::ostringstream counts;
+		counts << ", \"calls\": " << model.calls << ", \"true\": " << model.holds << ", \"comparisons\": " <<
+			model.comparisons << ", \"fails\": [";
+		for (std::size_t inx = 0; inx < model.fails.size(); ++inx)
+			counts << (inx ? ", " : "") << model.fails[inx];
+		counts << "]}";
+		const std::size_t start = json.str().find(object.str());
+		const std::string json_object = start == std::string::npos ? std::string() :
+			json.str().substr(start, json.str().find("]}", start) + 2 - start);
+		check::expect(!json_object.empty() && contains(json_object, "\"function\": \"") && contains(json_object, counts.str()),
+			"report_json of %s: \"%s\", expected the fields \"%s\"", name, json_object.c_str(), counts.str().c_str());
+		check::expect(json.str().front() == '[' && json.str().size() >= 3 && json.str().compare(json.str().size() - 3, 3, "\n]\n") == 0,
+			"report_json isn't an array");
+	}
+
+}
+
+int main() {
+	Models models;
+	check_sites(models, "before any call");
+
+	// The second thread waits after its calls, so its table is merged while it is alive
+	std::atomic<int> stage{ 0 };
+	Models other;
+	std::thread second([&] {
+		other = evaluate(2, 30000);
+		stage = 1;
+		while (stage.load() != 2)
+			std::this_thread::yield();
+	});
+	models = evaluate(1, 50000);
+	while (stage.load() != 1)
+		std::this_thread::yield();
+	models.merge(other);
+	check_sites(models, "the second thread running");
+	stage = 2;
+	second.join();
+	check_sites(models, "the second thread finished");
+
+	// The counts retired with the second thread and the ones of the main thread add up
+	Models more = evaluate(3, 1000);
+	models.merge(more);
+	check_sites(models, "after the second thread");
+
+	check_reports("chain", conductor_line, models.conductor);
+	check_reports("chain_root", node_line, models.node);
+	check_reports("branchless_chain", branchless_line, models.branchless);
+	return check::report("instrument");
+}
@@ -0,0 +1,103 @@
+//============================================================================
+// Name        : lazy_checks.cpp
+// Author      : Rahman Salim Zengin
+// Version     :
+// Copyright   : rsz@gufatek.com
+// Description : Evaluation counts of lazy operands
+//============================================================================
+
+/*
+ * A lazy operand is computed when the evaluation reaches it, at most once, even
+ * when it takes part in both of its adjacent comparisons, or in every pair of a
+ * non-transitive chain. A short-circuit engine doesn't compute it at all if an
+ * earlier link fails. A branchless engine evaluates every link, so it computes
+ * it once, but it compares the pairs of a non-transitive type by short-circuit
+ * evaluation as well. Checked for every engine, ascending and descending, with
+ * the lazy operand first, in the middle and last.
+ */
+
+#include <cstdio>
+#include <cstddef>
+#include <type_traits>
+
+#ifdef __GNUG__
+#include "../include/cmp.hpp"
+#else
+#include "..\include\cmp.hpp"
+#endif
+
+#include "check.hpp"
+
+namespace {
+
+	std::size_t evaluations = 0;
+
+	// A value computed once per evaluation of the chain, counting the computations
+	auto counted(int value) {
+		return cmp::lazy([value] { ++evaluations; return value; });
+	}
+
+	// An int of a type which isn't transitive, so its chains compare all pairs
+	struct Plain {
+		int value;
+	};
+
+	bool operator<(Plain lhs, Plain rhs) { return lhs.value < rhs.value; }
+	bool operator>(Plain lhs, Plain rhs) { return lhs.value > rhs.value; }
+
+	auto counted_plain(int value) {
+		return cmp::lazy([value] { ++evaluations; return Plain{ value }; });
+	}
+
+}
+
+template<>
+struct cmp::is_transitive<Plain> : std::false_type {};
+
+namespace {
+
+	void expect(const char* engine, const char* chain, bool result, bool expected, std::size_t count) {
+		check::expect(result == expected && evaluations == count, "%-16s %-24s: %d, %zu evaluations, expected %d, %zu",
+			engine, chain, int(result), evaluations, int(expected), count);
+		evaluations = 0;
+	}
+
+	template<typename Root>
+	void check_engine(const Root& root, const char* engine, bool branchless) {
+		// A link failing before the lazy operand leaves it out, unless every link is evaluated
+		const std::size_t skipped = branchless ? 1 : 0;
+		const int one = 1, two = 2, three = 3;
+
+		expect(engine, "1 < [2] < 3", root << one < counted(2) < three, true, 1);
+		expect(engine, "1 < [2] <= 1", root << one < counted(2) <= one, false, 1);
+		expect(engine, "1 <= [0] < 3", root << one <= counted(0) < three, false, 1);
+		expect(engine, "[1] < 2 <= 3", root << counted(1) < two <= three, true, 1);
+		expect(engine, "1 < 2 <= [3]", root << one < two <= counted(3), true, 1);
+		expect(engine, "2 < 1 < [3]", root << two < one < counted(3), false, skipped);
+		expect(engine, "3 < 2 < [4] < 5", root << three < two < counted(4) < 5, false, skipped);
+		expect(engine, "1 < 3 < 2 < [4]", root << one < three < two < counted(4), false, skipped);
+		expect(engine, "[1] < [2] < [3]", root << counted(1) < counted(2) < counted(3), true, 3);
+		expect(engine, "[2] < [1] < [3]", root << counted(2) < counted(1) < counted(3), false, branchless ? 3 : 2);
+
+		expect(engine, "3 > [2] >= 2", root >> three > counted(2) >= two, true, 1);
+		expect(engine, "3 > [3] > 1", root >> three > counted(3) > one, false, 1);
+		expect(engine, "1 > 2 > [0]", root >> one > two > counted(0), false, skipped);
+
+		// Compared with each of the other operands, computed once. All pairs are
+		// compared by short-circuit evaluation, whatever the policy is
+		const Plain p1{ 1 }, p3{ 3 }, p4{ 4 };
+		expect(engine, "all pairs 1 < [2] < 3 < 4", root << p1 < counted_plain(2) < p3 < p4, true, 1);
+		expect(engine, "all pairs 1 < [5] < 3 < 4", root << p1 < counted_plain(5) < p3 < p4, false, 1);
+		expect(engine, "all pairs 4 > 3 > [2] > 1", root >> p4 > p3 > counted_plain(2) > p1, true, 1);
+		expect(engine, "all pairs 3 < 1 < [2] < 4", root << p3 < p1 < counted_plain(2) < p4, false, 0);
+	}
+
+}
+
+int main() {
+	check_engine(cmp::chain_root, "chain_root", false);
+	check_engine(cmp::branchless_root, "branchless_root", true);
+	check_engine(cmp::chain, "chain", false);
+	check_engine(cmp::branchless_chain, "branchless_chain", true);
+	return check::report("lazy");
+}
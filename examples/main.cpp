@@ -29,6 +29,11 @@ int main() {
 
 	print(bool(express0));
 
+	// Chains of constant operands are constant expressions
+	static_assert(!(cmp::chain_root << 1 < 2 <= 2 < 5 <= 7 < 6), "Always false");
+	static_assert(cmp::chain << 1 < 2 <= 2 < 5, "Always true");
+	static_assert(cmp::chain_root >> 7 > 5 >= 5 > 2, "Descending");
+
 	
 
 	const int a = 6;
@@ -50,6 +55,47 @@ int main() {
 	}
 	std::cout << std::endl;
 
+	// Reusable predicate, the bounds are stored by value
+	auto in_range = cmp::chain << 5 < cmp::_ <= 15;
+	std::vector<int> numbers{ 3, 5, 8, 15, 21 };
+	print(std::count_if(numbers.begin(), numbers.end(), in_range));
+
+	// Interval computed once, one unsigned compare per element
+	auto in_interval = cmp::range(in_range);
+	print(std::count_if(numbers.begin(), numbers.end(), in_interval));
+
+	// The same elements of sorted numbers by two binary searches
+	for (auto x : cmp::equal_range(numbers, in_range))
+		std::cout << x << " ";
+	std::cout << std::endl;
+
+	// Descending numeric range, mixing "<" into it is a compilation error
+	for (auto x : numbers)
+		if (cmp::chain_root >> 15 > x >= 5)
+			std::cout << x << " ";
+	std::cout << std::endl;
+
+	// Histogram of the bins (-inf, 5), [5, 15], (15, +inf)
+	auto bins = cmp::buckets(cmp::chain << 5 <= 15);
+	for (auto count : bins.histogram(numbers))
+		std::cout << count << " ";
+	std::cout << std::endl;
+
+	// Key range of words, a "memcmp" of the shared prefix "ab" and a byte per word
+	std::vector<std::string> words{ "aback", "abbey", "abduct", "abide", "acme" };
+	auto in_keys = cmp::string_range(cmp::chain << "abb" <= cmp::_ < "abe");
+	for (const auto& word : words)
+		if (in_keys(word))
+			std::cout << word << " ";
+	std::cout << std::endl;
+
+	// Rows of three columns where 0.4 < a <= b <= c < 0.6
+	std::vector<double> col_a{ 0.5, 0.45, 0.3 }, col_b{ 0.55, 0.44, 0.5 }, col_c{ 0.58, 0.59, 0.5 };
+	for (auto row : cmp::select_index(cmp::chain << 0.4 < cmp::arg<0> <= cmp::arg<1> <= cmp::arg<2> < 0.6,
+		cmp::columns(col_a, col_b, col_c)))
+		std::cout << row << " ";
+	std::cout << std::endl;
+
 	//auto num0 = 'c';
 	//auto num1 = 15;
 	//auto num2 = 3.75;
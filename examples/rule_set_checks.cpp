@@ -0,0 +1,173 @@
+//============================================================================
+// Name        : rule_set_checks.cpp
+// Author      : Rahman Salim Zengin
+// Version     :
+// Copyright   : rsz@gufatek.com
+// Description : Random insert, remove and compact steps of "Rule_set"
+//============================================================================
+
+/*
+ * A "Rule_set" is checked against a plain list of the inserted predicates and
+ * whether each one is removed. Random steps insert a rule of one of the four
+ * strictness pairs, or of a one-sided form, remove a live, a removed or an
+ * unknown id, or compact the set. The bounds are small, so many rules are empty
+ * intervals and many match a value. Enough rules are inserted to fill several
+ * levels, and removals come in bursts so the set compacts itself. Each
+ * "remove()" must return whether the id was live. Every few steps "size()" and
+ * the ids of "match()" of single values and of an array are checked against the
+ * predicates which are live. Checked for int and for double, whose values
+ * include NaN and the infinities.
+ */
+
+#include <cmath>
+#include <cstdio>
+#include <cstddef>
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <random>
+#include <utility>
+#include <vector>
+
+#ifdef __GNUG__
+#include "../include/cmp.hpp"
+#else
+#include "..\include\cmp.hpp"
+#endif
+
+#include "check.hpp"
+
+namespace {
+
+	template<typename T> const char* type_name();
+	template<> const char* type_name<int>() { return "int"; }
+	template<> const char* type_name<double>() { return "double"; }
+
+	// The inserted predicates, indexed by rule id
+	template<typename T>
+	struct Model {
+		std::vector<std::function<bool(T)>> preds;
+		std::vector<bool> live;
+		std::size_t size = 0;
+
+		std::vector<std::size_t> match(T value) const {
+			std::vector<std::size_t> ids;
+			for (std::size_t id = 0; id < preds.size(); ++id)
+				if (live[id] && preds[id](value))
+					ids.push_back(id);
+			return ids;
+		}
+	};
+
+	// Inserts the same random rule into both
+	template<typename T>
+	void insert(std::mt19937_64& engine, cmp::Rule_set<T>& rules, Model<T>& model) {
+		const T lo = T(int(engine() % 21) - 10), hi = T(int(engine() % 21) - 10);
+		std::size_t id = 0;
+		const auto add = [&](const auto& pred) {
+			id = rules.insert(pred);
+			model.preds.push_back(pred);
+		};
+		switch (engine() % 8) {
+		case 0: add(cmp::chain << lo < cmp::_ < hi); break;
+		case 1: add(cmp::chain << lo < cmp::_ <= hi); break;
+		case 2: add(cmp::chain << lo <= cmp::_ < hi); break;
+		case 3: add(cmp::chain << lo <= cmp::_ <= hi); break;
+		case 4: add(cmp::chain << cmp::_ < hi); break;
+		case 5: add(cmp::chain << cmp::_ <= hi); break;
+		case 6: add(cmp::chain << lo < cmp::_); break;
+		default: add(cmp::chain << lo <= cmp::_); break;
+		}
+		check::expect(id == model.live.size(), "insert, %s: id %zu, expected %zu", type_name<T>(), id, model.live.size());
+		model.live.push_back(true);
+		++model.size;
+	}
+
+	// Removes a live rule mostly, sometimes a removed or an unknown one
+	template<typename T>
+	void remove(std::mt19937_64& engine, cmp::Rule_set<T>& rules, Model<T>& model) {
+		const std::size_t id = engine() % (model.live.size() + 2);
+		const bool live = id < model.live.size() && model.live[id];
+		const bool removed = rules.remove(id);
+		check::expect(removed == live, "remove %zu, %s: %d, expected %d", id, type_name<T>(), int(removed), int(live));
+		if (live) {
+			model.live[id] = false;
+			--model.size;
+		}
+	}
+
+	template<typename T>
+	void check_matches(const cmp::Rule_set<T>& rules, const Model<T>& model, const std::vector<T>& values, std::size_t step) {
+		check::expect(rules.size() == model.size, "size at step %zu, %s: %zu, expected %zu", step, type_name<T>(),
+			rules.size(), model.size);
+		std::vector<std::pair<std::size_t, std::size_t>> expected_pairs, pairs;
+		for (std::size_t inx = 0; inx < values.size(); ++inx) {
+			std::vector<std::size_t> ids = rules.match(values[inx]);
+			const std::vector<std::size_t> expected = model.match(values[inx]);
+			std::sort(ids.begin(), ids.end());
+			check::expect(ids == expected, "match of %g at step %zu, %s: %zu ids, expected %zu", double(values[inx]), step,
+				type_name<T>(), ids.size(), expected.size());
+			for (std::size_t id : expected)
+				expected_pairs.emplace_back(inx, id);
+		}
+		rules.match(values.data(), values.size(), [&pairs](std::size_t inx, std::size_t id) { pairs.emplace_back(inx, id); });
+		std::sort(pairs.begin(), pairs.end());
+		check::expect(pairs == expected_pairs, "batched match at step %zu, %s: %zu matches, expected %zu", step,
+			type_name<T>(), pairs.size(), expected_pairs.size());
+	}
+
+	template<typename T>
+	void check_type(unsigned seed) {
+		std::mt19937_64 engine(seed);
+		std::vector<T> values;
+		for (int value = -12; value <= 12; ++value)
+			values.push_back(T(value));
+		if constexpr (std::is_floating_point<T>::value) {
+			values.insert(values.end(), { T(-0.0), T(0.5), T(-9.5), std::numeric_limits<T>::quiet_NaN(),
+				std::numeric_limits<T>::infinity(), -std::numeric_limits<T>::infinity(), std::numeric_limits<T>::lowest() });
+		}
+		else
+			values.insert(values.end(), { std::numeric_limits<T>::lowest(), std::numeric_limits<T>::max() });
+
+		cmp::Rule_set<T> rules;
+		Model<T> model;
+		check_matches(rules, model, values, 0);
+		for (std::size_t step = 1; step <= 6000; ++step) {
+			// Phases of mostly inserting and of mostly removing
+			const bool removing = (step / 1000) % 2 == 1;
+			const std::size_t action = engine() % 100;
+			if (action < 2)
+				rules.compact();
+			else if (action < (removing ? 80u : 30u))
+				remove(engine, rules, model);
+			else
+				insert(engine, rules, model);
+			if (step % 7 == 0 || step < 200)
+				check_matches(rules, model, values, step);
+		}
+		// Everything removed, then refilled
+		for (std::size_t id = 0; id < model.live.size(); ++id) {
+			const bool removed = rules.remove(id);
+			check::expect(removed == model.live[id], "remove all %zu, %s", id, type_name<T>());
+			if (model.live[id]) {
+				model.live[id] = false;
+				--model.size;
+			}
+		}
+		check_matches(rules, model, values, 6001);
+		rules.compact();
+		check_matches(rules, model, values, 6002);
+		for (int count = 0; count < 300; ++count)
+			insert(engine, rules, model);
+		check_matches(rules, model, values, 6003);
+	}
+
+}
+
+int main() {
+	for (unsigned seed = 1; seed <= 4; ++seed) {
+		check_type<int>(seed);
+		check_type<double>(seed);
+	}
+	return check::report("rule_set");
+}
@@ -0,0 +1,56 @@
+#!/bin/sh
+#============================================================================
+# Name        : run_checks.sh
+# Description : Builds and runs every check program
+#============================================================================
+#
+# Builds each "*_checks.cpp", "comparisons.cpp" and "copies.cpp" and runs it,
+# "simd_checks.cpp" once more with its kernels capped at SSE2,
+# "three_way_checks.cpp" with -std=c++20 and "instrument_checks.cpp" with
+# -std=c++20 -DCMP_INSTRUMENT, which come after CXXFLAGS so they win. Only
+# compiles "constexpr_checks.cpp", whose checks are static_asserts.
+# Fails if a program doesn't build or doesn't pass, after running all of them.
+#
+# Usage: run_checks.sh [compiler]    (default: $CXX, or c++)
+#        CXXFLAGS="-std=c++20 -march=native" run_checks.sh clang++
+
+cd "$(dirname "$0")" || exit 1
+cxx=${1:-${CXX:-c++}}
+flags=${CXXFLAGS:--std=c++17 -O2}
+bin=$(mktemp -d) || exit 1
+trap 'rm -rf "$bin"' EXIT
+
+status=0
+# "name [flags...]" of a program to build and run
+run() {
+	name=$1
+	shift
+	if ! $cxx $flags -pthread "$@" "${name%%.*}.cpp" -o "$bin/$name"; then
+		echo "FAIL $name: compilation failed"
+		status=1
+	elif ! CXX=$cxx "$bin/$name"; then
+		status=1
+	fi
+}
+
+for source in *_checks.cpp comparisons.cpp copies.cpp; do
+	[ -e "$source" ] || continue
+	name=${source%.cpp}
+	case $name in
+	constexpr_checks | three_way_checks | instrument_checks) continue ;;
+	esac
+	run "$name"
+done
+run simd_checks.sse2 -DCMP_SIMD_LEVEL=1
+run three_way_checks -std=c++20
+run instrument_checks -std=c++20 -DCMP_INSTRUMENT
+
+if ! $cxx $flags -fsyntax-only constexpr_checks.cpp; then
+	echo "FAIL constexpr_checks: compilation failed"
+	status=1
+else
+	echo "constexpr ok"
+fi
+
+[ $status -eq 0 ] && echo "all checks ok" || echo "checks FAILED"
+exit $status
@@ -0,0 +1,183 @@
+//============================================================================
+// Name        : simd_checks.cpp
+// Author      : Rahman Salim Zengin
+// Version     :
+// Copyright   : rsz@gufatek.com
+// Description : Selection kernels against the scalar chain evaluation
+//============================================================================
+
+/*
+ * run_checks.sh builds it once more with -DCMP_SIMD_LEVEL=1.
+ *
+ * Every mask kernel of each instruction set the processor supports is called
+ * directly, whatever "isa_level()" would choose, for int32, int64, float and
+ * double elements with NaN, infinities, -0.0 and the limits of the type, by all
+ * four combinations of "<" and "<=". select_mask, select_index and select_count
+ * are checked at lengths which aren't multiples of a block or of a lane width,
+ * by the kernels of "isa_level()", which CMP_SIMD_LEVEL caps (0 to 3).
+ * Each bit must equal "pred(x)" of the predicate. A predicate of
+ * "branchless_chain" keeps its policy and selects the same elements, a
+ * descending one is selected by its scalar evaluation.
+ */
+
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <limits>
+#include <random>
+#include <vector>
+
+#ifdef __GNUG__
+#include "../include/cmp.hpp"
+#else
+#include "..\include\cmp.hpp"
+#endif
+
+#include "check.hpp"
+
+namespace {
+
+	void expect(bool ok, const char* what, const char* type, const char* ops) {
+		check::expect(ok, "%s, %s, %s", what, type, ops);
+	}
+
+	template<typename T> const char* type_name();
+	template<> const char* type_name<std::int32_t>() { return "int32"; }
+	template<> const char* type_name<std::int64_t>() { return "int64"; }
+	template<> const char* type_name<float>() { return "float"; }
+	template<> const char* type_name<double>() { return "double"; }
+
+	// 0: none, 1: SSE2, 2: AVX2, 3: AVX-512 of the processor, not capped by CMP_SIMD_LEVEL
+	int processor_level() {
+#if defined(CMP_SIMD_X86)
+		__builtin_cpu_init();
+		return __builtin_cpu_supports("avx512f") ? 3 : __builtin_cpu_supports("avx2") ? 2 :
+			__builtin_cpu_supports("sse2") ? 1 : 0;
+#else
+		return 0;
+#endif
+	}
+
+	// The values a kernel may compare differently from the scalar code
+	template<typename T>
+	std::vector<T> special_values() {
+		using limits = std::numeric_limits<T>;
+		std::vector<T> values = { limits::lowest(), T(limits::lowest() + 1), T(-1), T(0), T(1), T(limits::max() - 1), limits::max() };
+		if constexpr (std::is_floating_point<T>::value) {
+			values.insert(values.end(), { -limits::infinity(), limits::infinity(), limits::quiet_NaN(), -limits::quiet_NaN(),
+				T(-0.0), limits::min(), limits::denorm_min(), T(0.5), T(-0.5) });
+		}
+		return values;
+	}
+
+	// Special values and small random ones, so a bound often equals an element
+	template<typename T>
+	std::vector<T> sample(std::mt19937_64& engine, std::size_t n, const std::vector<T>& special) {
+		std::uniform_int_distribution<int> small(-8, 8);
+		std::uniform_int_distribution<std::size_t> pick(0, special.size() - 1);
+		std::vector<T> values(n);
+		for (auto& value : values)
+			value = engine() % 3 == 0 ? special[pick(engine)] : T(small(engine));
+		return values;
+	}
+
+	template<typename T, typename Pred>
+	std::vector<std::uint64_t> expected_mask(const Pred& pred, const std::vector<T>& data) {
+		std::vector<std::uint64_t> mask((data.size() + 63) / 64);
+		for (std::size_t inx = 0; inx < data.size(); ++inx)
+			mask[inx / 64] |= std::uint64_t(bool(pred(data[inx]))) << (inx % 64);
+		return mask;
+	}
+
+	// The kernels of the given operators at every level, forced by calling them directly
+	template<typename T, typename LowerOp, typename UpperOp, typename Pred>
+	void check_kernels(const Pred& pred, T lo, T hi, const std::vector<T>& data, const char* ops) {
+		const std::vector<std::uint64_t> expected = expected_mask<T>(pred, data);
+		const std::size_t blocks = data.size() / 64;
+		std::vector<std::uint64_t> masks(blocks);
+		const auto check = [&](cmp::Mask_kernel<T> kernel, const char* name) {
+			if (!kernel)
+				return;
+			kernel(data.data(), blocks, masks.data(), lo, hi);
+			expect(std::equal(masks.begin(), masks.end(), expected.begin()), name, type_name<T>(), ops);
+		};
+		check(&cmp::simd::mask_scalar<T, LowerOp, UpperOp>, "scalar kernel");
+#if defined(CMP_SIMD_X86)
+		using namespace cmp::simd;
+		const int level = processor_level();
+		if (level >= 1)
+			check(sse2_kernel<T, LowerOp, UpperOp>(std::integral_constant<bool, Sse2_lanes<T>::enabled>{}), "SSE2 kernel");
+		if (level >= 2)
+			check(avx2_kernel<T, LowerOp, UpperOp>(std::integral_constant<bool, Avx2_lanes<T>::enabled>{}), "AVX2 kernel");
+		if (level >= 3)
+			check(avx512_kernel<T, LowerOp, UpperOp>(std::integral_constant<bool, Avx512_lanes<T>::enabled>{}), "AVX-512 kernel");
+#endif
+	}
+
+	// The selection functions at lengths around the blocks and the chunks of the kernels
+	template<typename T, typename Pred>
+	void check_select(const Pred& pred, const std::vector<T>& data, const char* ops) {
+		static const std::size_t lengths[] = { 0, 1, 3, 7, 15, 17, 63, 64, 65, 127, 129, 1001, 2047, 64 * 32 + 5, 64 * 65 + 33 };
+		for (std::size_t n : lengths) {
+			const std::vector<T> part(data.begin(), data.begin() + std::ptrdiff_t(std::min(n, data.size())));
+			const std::vector<std::uint64_t> expected = expected_mask<T>(pred, part);
+			expect(cmp::select_mask(pred, part) == expected, "select_mask", type_name<T>(), ops);
+			std::vector<std::size_t> index;
+			for (std::size_t inx = 0; inx < part.size(); ++inx)
+				if (pred(part[inx]))
+					index.push_back(inx);
+			expect(cmp::select_index(pred, part) == index, "select_index", type_name<T>(), ops);
+			expect(cmp::select_count(pred, part) == index.size(), "select_count", type_name<T>(), ops);
+		}
+	}
+
+	template<typename T, typename LowerOp, typename UpperOp, typename Pred>
+	void check_pred(const Pred& pred, T lo, T hi, const std::vector<T>& data, const char* ops) {
+		check_kernels<T, LowerOp, UpperOp>(pred, lo, hi, data, ops);
+		check_select(pred, data, ops);
+	}
+
+	// A placeholder keeps the policy of the initiator
+	static_assert(std::is_same<decltype(cmp::branchless_chain << 1 < cmp::_ < 2)::policy, cmp::Evaluation::Branchless>::value &&
+		!std::is_same<decltype(cmp::branchless_chain << 1 < cmp::_ < 2), decltype(cmp::chain << 1 < cmp::_ < 2)>::value,
+		"branchless_chain predicate lost its policy");
+
+	template<typename T>
+	void check_type(std::mt19937_64& engine) {
+		using Lt = cmp::Operation::LowerThan;
+		using Le = cmp::Operation::LowerThanEqual;
+		const std::vector<T> special = special_values<T>();
+		const std::vector<T> data = sample<T>(engine, 64 * 65 + 33, special);
+
+		// Each special value and a few random ones as each bound
+		std::vector<T> bounds = special;
+		const std::vector<T> random = sample<T>(engine, 6, special);
+		bounds.insert(bounds.end(), random.begin(), random.end());
+		for (T lo : bounds) {
+			for (T hi : bounds) {
+				check_pred<T, Lt, Lt>(cmp::chain << lo < cmp::_ < hi, lo, hi, data, "lo < _ < hi");
+				check_pred<T, Lt, Le>(cmp::chain << lo < cmp::_ <= hi, lo, hi, data, "lo < _ <= hi");
+				check_pred<T, Le, Lt>(cmp::chain << lo <= cmp::_ < hi, lo, hi, data, "lo <= _ < hi");
+				check_pred<T, Le, Le>(cmp::chain << lo <= cmp::_ <= hi, lo, hi, data, "lo <= _ <= hi");
+				check_pred<T, Lt, Le>(cmp::branchless_chain << lo < cmp::_ <= hi, lo, hi, data, "branchless lo < _ <= hi");
+			}
+			check_select(cmp::chain << cmp::_ < lo, data, "_ < lo");
+			check_select(cmp::chain << lo <= cmp::_, data, "lo <= _");
+			check_select(cmp::chain >> lo > cmp::_ >= T(0), data, "lo > _ >= 0");
+		}
+	}
+
+}
+
+int main() {
+	std::mt19937_64 engine(7);
+	check_type<std::int32_t>(engine);
+	check_type<std::int64_t>(engine);
+	check_type<float>(engine);
+	check_type<double>(engine);
+#if defined(CMP_SIMD_X86)
+	std::printf("kernels checked up to level %d, select functions at level %d (0: none, 1: SSE2, 2: AVX2, 3: AVX-512)\n",
+		processor_level(), cmp::simd::isa_level());
+#endif
+	return check::report("simd");
+}
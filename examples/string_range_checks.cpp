@@ -0,0 +1,118 @@
+//============================================================================
+// Name        : string_range_checks.cpp
+// Author      : Rahman Salim Zengin
+// Version     :
+// Copyright   : rsz@gufatek.com
+// Description : "string_range" against its predicate
+//============================================================================
+
+/*
+ * Every string of up to 3 bytes of the alphabet '\0', 'a', 'b', '\x80' and
+ * '\xff' is checked against every pair of such bounds, so a lower bound may be
+ * longer than the upper one, either bound may be a prefix of the other, and a
+ * byte may be at or above 0x80. Random strings of up to 8 bytes are checked as
+ * well. A "string_range" of each strictness pair, and of each one-sided form,
+ * must agree with the predicate it is made of, comparing std::string operands.
+ */
+
+#include <cstdio>
+#include <cstddef>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#ifdef __GNUG__
+#include "../include/cmp.hpp"
+#else
+#include "..\include\cmp.hpp"
+#endif
+
+#include "check.hpp"
+
+namespace {
+
+	const char alphabet[] = { '\0', 'a', 'b', '\x80', '\xff' };
+
+	// The bytes of a string in hex, so '\0' and the high bytes are visible
+	std::string hex(const std::string& text) {
+		static const char digits[] = "0123456789abcdef";
+		std::string out = "\"";
+		for (unsigned char byte : text) {
+			out += digits[byte >> 4];
+			out += digits[byte & 15];
+		}
+		return out + "\"";
+	}
+
+	template<typename Pred>
+	void check_form(const Pred& pred, const char* form, const std::string& lo, const std::string& hi,
+		const std::vector<std::string>& values) {
+		const auto range = cmp::string_range(pred);
+		for (const std::string& value : values) {
+			const bool expected = pred(value);
+			check::expect(range(value) == expected && range(std::string_view(value)) == expected,
+				"%s, lo %s, hi %s, value %s: %d, expected %d", form, hex(lo).c_str(), hex(hi).c_str(), hex(value).c_str(),
+				int(range(value)), int(expected));
+		}
+	}
+
+	void check_bounds(const std::string& lo, const std::string& hi, const std::vector<std::string>& values) {
+		check_form(cmp::chain << lo < cmp::_ < hi, "lo < _ < hi", lo, hi, values);
+		check_form(cmp::chain << lo < cmp::_ <= hi, "lo < _ <= hi", lo, hi, values);
+		check_form(cmp::chain << lo <= cmp::_ < hi, "lo <= _ < hi", lo, hi, values);
+		check_form(cmp::chain << lo <= cmp::_ <= hi, "lo <= _ <= hi", lo, hi, values);
+	}
+
+	void check_one_sided(const std::string& bound, const std::vector<std::string>& values) {
+		check_form(cmp::chain << cmp::_ < bound, "_ < hi", bound, bound, values);
+		check_form(cmp::chain << cmp::_ <= bound, "_ <= hi", bound, bound, values);
+		check_form(cmp::chain << bound < cmp::_, "lo < _", bound, bound, values);
+		check_form(cmp::chain << bound <= cmp::_, "lo <= _", bound, bound, values);
+	}
+
+	// Every string of up to "length" bytes of the alphabet
+	std::vector<std::string> all_strings(std::size_t length) {
+		std::vector<std::string> strings = { std::string() };
+		for (std::size_t begin = 0, size = 1; size <= length; ++size) {
+			const std::size_t end = strings.size();
+			for (std::size_t inx = begin; inx < end; ++inx)
+				for (char byte : alphabet)
+					strings.push_back(strings[inx] + byte);
+			begin = end;
+		}
+		return strings;
+	}
+
+	std::string random_string(std::mt19937_64& engine, std::size_t max_length) {
+		std::string text(engine() % (max_length + 1), '\0');
+		for (char& byte : text)
+			byte = alphabet[engine() % sizeof(alphabet)];
+		return text;
+	}
+
+}
+
+int main() {
+	const std::vector<std::string> strings = all_strings(3);
+	for (const std::string& lo : strings) {
+		for (const std::string& hi : strings)
+			check_bounds(lo, hi, strings);
+		check_one_sided(lo, strings);
+	}
+
+	std::mt19937_64 engine(21);
+	std::vector<std::string> values(400);
+	for (int round = 0; round < 2000; ++round) {
+		for (auto& value : values)
+			value = random_string(engine, 8);
+		// Bounds sharing a prefix, so the values are often compared past it
+		const std::string prefix = random_string(engine, 3);
+		const std::string lo = prefix + random_string(engine, 5), hi = prefix + random_string(engine, 5);
+		for (std::size_t inx = 0; inx < values.size(); inx += 2)
+			values[inx] = prefix + values[inx];
+		check_bounds(lo, hi, values);
+		check_one_sided(lo, values);
+	}
+	return check::report("string_range");
+}
@@ -0,0 +1,156 @@
+//============================================================================
+// Name        : three_way_checks.cpp
+// Author      : Rahman Salim Zengin
+// Version     :
+// Copyright   : rsz@gufatek.com
+// Description : The C++20 three-way comparison path of the chains
+//============================================================================
+
+/*
+ * C++20 only, run_checks.sh builds it with -std=c++20.
+ * Links of mixed "const char*", char array, "std::string" and "std::string_view"
+ * operands are compared as string views, and must agree with std::string
+ * comparisons, ascending and descending, by every engine and by predicates.
+ * A class having "operator<=>" is compared once per link by it, its "<" isn't
+ * called. A class converting to "std::string_view" with an ordering of its own,
+ * case-insensitive here, must keep that ordering.
+ */
+
+#include <cstdio>
+#include <cstddef>
+#include <compare>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#ifdef __GNUG__
+#include "../include/cmp.hpp"
+#else
+#include "..\include\cmp.hpp"
+#endif
+
+#include "check.hpp"
+
+#if !defined(CMP_THREE_WAY)
+#error "three_way_checks.cpp requires C++20 and the three-way comparison library"
+#endif
+
+namespace {
+
+	// Compared by "<=>", counting the calls of "<=>" and of "<"
+	struct Ordinal {
+		int value;
+
+		static inline std::size_t three_way = 0;
+		static inline std::size_t less = 0;
+
+		friend std::strong_ordering operator<=>(const Ordinal& lhs, const Ordinal& rhs) {
+			++three_way;
+			return lhs.value <=> rhs.value;
+		}
+		friend bool operator==(const Ordinal& lhs, const Ordinal& rhs) { return lhs.value == rhs.value; }
+		friend bool operator<(const Ordinal& lhs, const Ordinal& rhs) { ++less; return lhs.value < rhs.value; }
+	};
+
+	// A case-insensitive string, converting to std::string_view but ordered by its own operators
+	struct Caseless {
+		std::string text;
+
+		operator std::string_view() const { return text; }
+
+		static int compare(const Caseless& lhs, const Caseless& rhs) {
+			const std::size_t size = std::min(lhs.text.size(), rhs.text.size());
+			for (std::size_t inx = 0; inx < size; ++inx) {
+				const int l = lower(lhs.text[inx]), r = lower(rhs.text[inx]);
+				if (l != r)
+					return l < r ? -1 : 1;
+			}
+			return lhs.text.size() < rhs.text.size() ? -1 : lhs.text.size() > rhs.text.size() ? 1 : 0;
+		}
+
+		static int lower(char c) { return c >= 'A' && c <= 'Z' ? c - 'A' + 'a' : (unsigned char)c; }
+	};
+
+	bool operator<(const Caseless& lhs, const Caseless& rhs) { return Caseless::compare(lhs, rhs) < 0; }
+	bool operator<=(const Caseless& lhs, const Caseless& rhs) { return Caseless::compare(lhs, rhs) <= 0; }
+	bool operator>(const Caseless& lhs, const Caseless& rhs) { return Caseless::compare(lhs, rhs) > 0; }
+	bool operator>=(const Caseless& lhs, const Caseless& rhs) { return Caseless::compare(lhs, rhs) >= 0; }
+
+	void expect(const char* name, bool result, bool expected, const std::string& a, const std::string& b,
+		const std::string& c) {
+		check::expect(result == expected, "%s of \"%s\" \"%s\" \"%s\": %d, expected %d", name, a.c_str(), b.c_str(),
+			c.c_str(), int(result), int(expected));
+	}
+
+	// Every triple of the strings as "const char*", std::string and std::string_view operands
+	void check_strings() {
+		const std::vector<std::string> texts = { "", "a", "ab", "abc", "b", "B", "ba", "\x7f", "\x80", "\xff" };
+		for (const std::string& a : texts) {
+			for (const std::string& b : texts) {
+				for (const std::string& c : texts) {
+					const char* pa = a.c_str();
+					const std::string_view vc(c);
+					const bool asc = a < b && b <= c;
+					const bool desc = a > b && b >= c;
+					expect("chain pointer < string <= view", bool(cmp::chain << pa < b <= vc), asc, a, b, c);
+					expect("chain_root pointer < string <= view", bool(cmp::chain_root << pa < b <= vc), asc, a, b, c);
+					expect("branchless_chain pointer < string <= view", bool(cmp::branchless_chain << pa < b <= vc), asc, a, b, c);
+					expect("chain view < pointer <= string", bool(cmp::chain << std::string_view(a) < b.c_str() <= c),
+						asc, a, b, c);
+					expect("chain pointer > string >= view", bool(cmp::chain >> pa > b >= vc), desc, a, b, c);
+					expect("chain_root pointer > string >= view", bool(cmp::chain_root >> pa > b >= vc), desc, a, b, c);
+					expect("predicate pointer < _ <= view", (cmp::chain << pa < cmp::_ <= vc)(b), asc, a, b, c);
+					expect("predicate string < _ <= pointer", (cmp::chain << a < cmp::_ <= c.c_str())(std::string_view(b)),
+						asc, a, b, c);
+				}
+			}
+			// A char array bound
+			expect("chain array < string", bool(cmp::chain << "ab" < a), std::string("ab") < a, "ab", a, "");
+			expect("chain_root string <= array", bool(cmp::chain_root << a <= "b"), a <= std::string("b"), a, "b", "");
+		}
+	}
+
+	void check_three_way() {
+		const Ordinal one{ 1 }, two{ 2 }, three{ 3 };
+		Ordinal::three_way = Ordinal::less = 0;
+		check::expect(bool(cmp::chain << one < two <= two < three), "Ordinal chain");
+		check::expect(Ordinal::three_way == 3 && Ordinal::less == 0, "Ordinal chain: %zu <=>, %zu <, expected 3 and 0",
+			Ordinal::three_way, Ordinal::less);
+		Ordinal::three_way = Ordinal::less = 0;
+		check::expect(!(cmp::chain_root << one < three < two), "Ordinal chain_root");
+		check::expect(Ordinal::three_way == 2 && Ordinal::less == 0, "Ordinal chain_root: %zu <=>, %zu <, expected 2 and 0",
+			Ordinal::three_way, Ordinal::less);
+		Ordinal::three_way = Ordinal::less = 0;
+		check::expect(bool(cmp::chain >> three > two >= one), "Ordinal descending chain");
+		check::expect(Ordinal::three_way == 2 && Ordinal::less == 0, "Ordinal descending: %zu <=>, %zu <, expected 2 and 0",
+			Ordinal::three_way, Ordinal::less);
+	}
+
+	void check_own_ordering() {
+		const std::vector<std::string> texts = { "apple", "Apple", "APPLE", "Banana", "banana", "cherry", "Cherry", "" };
+		for (const std::string& a : texts) {
+			for (const std::string& b : texts) {
+				for (const std::string& c : texts) {
+					const Caseless x{ a }, y{ b }, z{ c };
+					const bool asc = x < y && y <= z;
+					const bool desc = x > y && y >= z;
+					expect("Caseless chain", bool(cmp::chain << x < y <= z), asc, a, b, c);
+					expect("Caseless chain_root", bool(cmp::chain_root << x < y <= z), asc, a, b, c);
+					expect("Caseless branchless_chain", bool(cmp::branchless_chain << x < y <= z), asc, a, b, c);
+					expect("Caseless descending chain", bool(cmp::chain >> x > y >= z), desc, a, b, c);
+					expect("Caseless predicate", (cmp::chain << x < cmp::_ <= z)(y), asc, a, b, c);
+				}
+			}
+		}
+		// The case the string view detour got wrong
+		check::expect(bool(cmp::chain << Caseless{ "apple" } < Caseless{ "Banana" }), "Caseless apple < Banana");
+	}
+
+}
+
+int main() {
+	check_strings();
+	check_three_way();
+	check_own_ordering();
+	return check::report("three-way");
+}
@@ -0,0 +1,152 @@
+//============================================================================
+// Name        : transitivity_checks.cpp
+// Author      : Rahman Salim Zengin
+// Version     :
+// Copyright   : rsz@gufatek.com
+// Description : Chains and predicates of a non-transitive type
+//============================================================================
+
+/*
+ * "Hand" is ordered as rock < paper < scissors < rock, so "is_transitive" is
+ * specialized as false. Every engine, a predicate and its consumers included,
+ * must compare all of the pairs: "rock < paper < scissors" is false because
+ * "rock < scissors" is. The results are checked against a plain loop over the
+ * pairs, for every hand at every operand and every pattern of links.
+ */
+
+#include <cstdio>
+#include <cstdint>
+#include <cstddef>
+#include <array>
+#include <vector>
+#include <type_traits>
+
+#ifdef __GNUG__
+#include "../include/cmp.hpp"
+#else
+#include "..\include\cmp.hpp"
+#endif
+
+#include "check.hpp"
+
+namespace {
+
+	// 0 rock, 1 paper, 2 scissors, each one beaten by the next
+	struct Hand {
+		int shape = 0;
+	};
+
+	constexpr bool operator<(Hand lhs, Hand rhs) { return (lhs.shape + 1) % 3 == rhs.shape; }
+	constexpr bool operator<=(Hand lhs, Hand rhs) { return lhs.shape == rhs.shape || lhs < rhs; }
+
+	constexpr Hand rock{ 0 }, paper{ 1 }, scissors{ 2 };
+
+}
+
+template<>
+struct cmp::is_transitive<Hand> : std::false_type {};
+
+namespace {
+
+	void expect(const char* name, bool result, bool expected) {
+		check::expect(result == expected, "%s: %d, expected %d", name, int(result), int(expected));
+	}
+
+	// A pair is compared strictly if any link between them is strict
+	bool all_pairs(const Hand* hands, const bool* strict, std::size_t size) {
+		for (std::size_t lhs = 0; lhs + 1 < size; ++lhs) {
+			bool strict_pair = false;
+			for (std::size_t rhs = lhs + 1; rhs < size; ++rhs) {
+				strict_pair = strict_pair || strict[rhs - 1];
+				if (!(strict_pair ? hands[lhs] < hands[rhs] : hands[lhs] <= hands[rhs]))
+					return false;
+			}
+		}
+		return true;
+	}
+
+	// Every engine of a four operand chain, the links "Op1" to "Op3" are strict as "strict" says
+	template<typename Op1, typename Op2, typename Op3>
+	void check_pattern(const char* name, const bool (&strict)[3]) {
+		const auto link = [](auto chain, auto op, const auto& rhs) {
+			if constexpr (std::is_same<decltype(op), cmp::Operation::LowerThan>::value)
+				return std::move(chain) < rhs;
+			else
+				return std::move(chain) <= rhs;
+		};
+		const auto pred = link(link(link(cmp::chain << cmp::arg<0>, Op1{}, cmp::arg<1>), Op2{}, cmp::arg<2>),
+			Op3{}, cmp::arg<3>);
+		const auto middle = link(link(link(cmp::chain << rock, Op1{}, cmp::_), Op2{}, paper), Op3{}, scissors);
+		auto learning = cmp::adaptive(pred);
+		const auto& shared = learning;
+
+		std::vector<cmp::Link> links;
+		for (bool is_strict : strict)
+			links.push_back(is_strict ? cmp::Link::LowerThan : cmp::Link::LowerThanEqual);
+		const auto runtime = cmp::dynamic_chain<Hand>({ cmp::arg<0>, cmp::arg<1>, cmp::arg<2>, cmp::arg<3> }, links);
+
+		std::vector<Hand> columns[4];
+		std::vector<bool> expected;
+		for (int code = 0; code < 81; ++code) {
+			const Hand hands[4] = { { code % 3 }, { code / 3 % 3 }, { code / 9 % 3 }, { code / 27 } };
+			const bool result = all_pairs(hands, strict, 4);
+			const bool with_middle = all_pairs(std::array<Hand, 4>{ { rock, hands[0], paper, scissors } }.data(), strict, 4);
+			const auto& [a, b, c, d] = hands;
+			expect(name, pred(a, b, c, d), result);
+			expect(name, runtime(a, b, c, d), result);
+			expect(name, middle(a), with_middle);
+			// As many calls as would sample and reorder the links of a transitive type
+			for (std::size_t call = 0; call < 2 * cmp::Adaptive<decltype(pred)>::sample_period; ++call)
+				expect(name, learning(a, b, c, d), result);
+			expect(name, shared(a, b, c, d), result);
+			for (std::size_t inx = 0; inx < 4; ++inx)
+				columns[inx].push_back(hands[inx]);
+			expected.push_back(result);
+		}
+
+		// Consumers of the predicate over columns
+		const auto mask = cmp::select_mask(pred, cmp::columns(columns[0], columns[1], columns[2], columns[3]));
+		std::size_t count = 0;
+		for (std::size_t row = 0; row < expected.size(); ++row) {
+			expect(name, (mask[row / 64] >> (row % 64)) & 1, expected[row]);
+			count += expected[row];
+		}
+		expect(name, cmp::select_count(pred, cmp::columns(columns[0], columns[1], columns[2], columns[3])) == count, true);
+		const Hand* data[] = { columns[0].data(), columns[1].data(), columns[2].data(), columns[3].data() };
+		std::vector<std::uint64_t> runtime_mask((expected.size() + 63) / 64);
+		runtime.select_mask(data, expected.size(), runtime_mask.data());
+		expect(name, runtime_mask == mask, true);
+	}
+
+}
+
+int main() {
+	// The example of a cycle, each link holds but the chain doesn't
+	expect("chain_root", cmp::chain_root << rock < paper < scissors, false);
+	expect("chain", cmp::chain << rock < paper < scissors, false);
+	expect("predicate", (cmp::chain << cmp::_ < paper < scissors)(rock), false);
+	expect("predicate, middle", (cmp::chain << rock < cmp::_ < scissors)(paper), false);
+	expect("predicate, last", (cmp::chain << rock < paper < cmp::_)(scissors), false);
+	expect("dynamic_chain", cmp::dynamic_chain<Hand>({ rock, paper, scissors },
+		{ cmp::Link::LowerThan, cmp::Link::LowerThan })(), false);
+	expect("predicate, two links", (cmp::chain << cmp::_ < paper)(rock), true);
+
+	// The select functions over a single column
+	const std::vector<Hand> hands = { rock, paper, scissors, rock, paper };
+	const auto pred = cmp::chain << cmp::_ < paper < scissors;
+	expect("select_count", cmp::select_count(pred, hands) == 0, true);
+	expect("select_index", cmp::select_index(pred, hands).empty(), true);
+	const auto upto = cmp::chain << cmp::_ <= paper < scissors;
+	expect("select_count, non-strict", cmp::select_count(upto, hands) == 2, true);
+
+	// A transitive argument still compares only the neighbours
+	expect("predicate of int", (cmp::chain << 1 < cmp::_ < 3)(2), true);
+
+	check_pattern<cmp::Operation::LowerThan, cmp::Operation::LowerThan, cmp::Operation::LowerThan>("< < <", { true, true, true });
+	check_pattern<cmp::Operation::LowerThan, cmp::Operation::LowerThanEqual, cmp::Operation::LowerThan>("< <= <", { true, false, true });
+	check_pattern<cmp::Operation::LowerThanEqual, cmp::Operation::LowerThan, cmp::Operation::LowerThanEqual>("<= < <=", { false, true, false });
+	check_pattern<cmp::Operation::LowerThanEqual, cmp::Operation::LowerThanEqual, cmp::Operation::LowerThanEqual>("<= <= <=", { false, false, false });
+	check_pattern<cmp::Operation::LowerThan, cmp::Operation::LowerThanEqual, cmp::Operation::LowerThanEqual>("< <= <=", { true, false, false });
+
+	return check::report("transitivity");
+}
@@ -13,127 +13,753 @@
 #include <cassert>
 #include <tuple>
 #include <functional>
+#include <algorithm>
+#include <utility>
+#include <cstdint>
+#include <limits>
+#include <vector>
+#include <array>
+#include <memory>
+#include <optional>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <cstring>
+#include <thread>
+#include <exception>
+#include <atomic>
+
+/*
+ * The SIMD kernels are compiled only for x86 by GCC or Clang. Defining
+ * CMP_SIMD_LEVEL caps the instruction set of the kernels chosen at runtime,
+ * e.g. to check a lower level on a newer processor or to avoid AVX-512 entirely,
+ * 0 leaves them out together with <immintrin.h>.
+ */
+#ifndef CMP_SIMD_LEVEL
+#define CMP_SIMD_LEVEL 3
+#endif
+
+#if CMP_SIMD_LEVEL > 0 && defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define CMP_SIMD_X86 1
+#include <immintrin.h>
+#endif
+
+#if __cplusplus >= 202002L
+#include <compare>
+#include <concepts>
+#if defined(__cpp_lib_three_way_comparison) && defined(__cpp_lib_concepts)
+#define CMP_THREE_WAY 1
+#endif
+#endif
+
+/*
+ * Defining CMP_INSTRUMENT before including this header counts the chain
+ * evaluations of each call site, see "cmp::instrument". It requires C++20.
+ */
+#if defined(CMP_INSTRUMENT)
+#if __cplusplus < 202002L
+#error "CMP_INSTRUMENT requires C++20 std::source_location"
+#endif
+#include <source_location>
+#include <atomic>
+#include <mutex>
+#include <map>
+#include <ostream>
+#endif
 
 namespace cmp {
 
 	template<std::size_t N> struct Element {};
 
+	/*
+	 * Evaluation strategies of a chain.
+	 * "Adjacent" compares only the neighbouring operands and stops at the first
+	 * failing link. N operands take at most N - 1 comparisons.
+	 * "AllPairs" compares every operand with all of the succeeding operands.
+	 * It takes N * (N - 1) / 2 comparisons and it is required only for the
+	 * types which are not transitively ordered.
+	 * "Branchless" computes all of the adjacent comparisons and combines them
+	 * with "&", it is chosen by the "Evaluation::Branchless" policy.
+	 * "AlwaysFalse" is chosen when the compile time constants of a transitive
+	 * chain contradict, e.g. "5 < y < 0". Nothing is compared at runtime.
+	 */
+	struct Strategy {
+		struct Adjacent {};
+		struct AllPairs {};
+		struct Branchless {};
+		struct AlwaysFalse {};
+	};
+
+	/*
+	 * Evaluation policy of a chain, selected by its root.
+	 * "ShortCircuit" stops at the first failing link, which is the best for
+	 * predictable data. "Branchless" avoids the hard to predict branches
+	 * of random data, e.g. cmp::branchless_root << lo < x < hi.
+	 */
+	struct Evaluation {
+		struct ShortCircuit {};
+		struct Branchless {};
+	};
+
+	// Helper type for controlling of the chain order
+	struct Order {
+		struct Ascending;
+		struct Descending;
+	};
+
+	template<typename Policy, bool Transitive>
+	using strategy_for = std::conditional_t<!Transitive, Strategy::AllPairs,
+		std::conditional_t<std::is_same<Policy, Evaluation::Branchless>::value, Strategy::Branchless, Strategy::Adjacent>>;
+
+	/*
+	 * Every type is assumed to have a transitive order (arithmetic types,
+	 * std::string, any type with a strict weak ordering).
+	 * Specialize it as std::false_type for a user type with a non-transitive
+	 * comparison. Chains including such a type are evaluated by "AllPairs".
+	 */
+	template<typename T>
+	struct is_transitive : std::true_type {};
+
+	/*
+	 * "std::integral_constant" operands are compile time constants of a chain.
+	 * Two succeeding constants are checked with "<" if any link between them
+	 * is strict, otherwise with "<=". Constants of a descending chain are
+	 * checked in reverse.
+	 */
+	template<typename T>
+	struct is_constant : std::false_type {};
+
+	template<typename T, T V>
+	struct is_constant<std::integral_constant<T, V>> : std::true_type {};
+
+	template<typename Previous, typename Current, bool Strict>
+	struct is_ordered : std::true_type {};
+
+	template<typename PType, PType PValue, typename CType, CType CValue, bool Strict>
+	struct is_ordered<std::integral_constant<PType, PValue>, std::integral_constant<CType, CValue>, Strict> :
+		std::integral_constant<bool, Strict ? (PValue < CValue) : (PValue <= CValue)> {};
+
+	/*
+	 * "Lazy" operand is computed only when the evaluation reaches it, and at most
+	 * once, e.g. cmp::chain_root << lo < cmp::lazy([&] { return lookup(key); }) < hi.
+	 * It is meant for a single evaluation of a chain expression.
+	 */
+	template<typename Func>
+	class Lazy {
+	public:
+		using value_type = std::decay_t<std::invoke_result_t<Func&>>;
+
+		constexpr explicit Lazy(Func func) : func_(std::move(func)) {}
+
+		const value_type& get() const {
+			if (!value_)
+				value_.emplace(func_());
+			return *value_;
+		}
+
+	private:
+		mutable Func func_;
+		mutable std::optional<value_type> value_;
+	};
+
+	template<typename Func>
+	constexpr Lazy<Func> lazy(Func func) {
+		return Lazy<Func>(std::move(func));
+	}
+
+	template<typename T>
+	struct is_lazy : std::false_type {};
+
+	template<typename Func>
+	struct is_lazy<Lazy<Func>> : std::true_type {};
+
+	template<typename Func>
+	struct is_transitive<Lazy<Func>> : is_transitive<typename Lazy<Func>::value_type> {};
+
+	// Operands are compared through "value_of", which computes a lazy operand
+	template<typename T>
+	constexpr const T& value_of(const T& operand) {
+		return operand;
+	}
+
+	template<typename Func>
+	const auto& value_of(const Lazy<Func>& operand) {
+		return operand.get();
+	}
+
+#if defined(CMP_THREE_WAY)
+	// The standard string types, a user type converting to "std::string_view" keeps its own ordering
+	template<typename T>
+	constexpr bool is_std_string = std::is_same_v<T, std::string> || std::is_same_v<T, std::string_view> ||
+		std::is_same_v<std::decay_t<T>, const char*> || std::is_same_v<std::decay_t<T>, char*>;
+
+	// Mixed string operands, e.g. "const char*" and "std::string", are compared as string views
+	template<typename LType, typename RType>
+	constexpr bool is_string_pair = is_std_string<std::remove_cv_t<LType>> && is_std_string<std::remove_cv_t<RType>> &&
+		(std::is_class_v<LType> || std::is_class_v<RType>);
+
+	template<typename Op>
+	constexpr bool is_ordering_op = std::is_same_v<Op, std::less<>> || std::is_same_v<Op, std::less_equal<>> ||
+		std::is_same_v<Op, std::greater<>> || std::is_same_v<Op, std::greater_equal<>>;
+
+	// The link operator tested on the result of "<=>", e.g. "<" is "ordering < 0"
+	template<typename Op, typename Ordering>
+	constexpr bool ordering_holds(Ordering ordering) {
+		if constexpr (std::is_same_v<Op, std::less<>>) { return ordering < 0; }
+		else if constexpr (std::is_same_v<Op, std::less_equal<>>) { return ordering <= 0; }
+		else if constexpr (std::is_same_v<Op, std::greater<>>) { return ordering > 0; }
+		else { return ordering >= 0; }
+	}
+#endif
+
+	/*
+	 * Every link of a chain is compared by "link_compare".
+	 * In C++20 mode, class type operands having "operator<=>" are compared once
+	 * by "std::compare_three_way" and the link operator is derived from the
+	 * ordering. Mixed operands of the standard string types are compared as
+	 * "std::string_view", so no temporary string is created.
+	 */
+	template<typename Op, typename LType, typename RType>
+	constexpr bool link_compare(Op op, const LType& lhs, const RType& rhs) {
+#if defined(CMP_THREE_WAY)
+		if constexpr (is_ordering_op<Op> && is_string_pair<LType, RType>) {
+			return ordering_holds<Op>(std::compare_three_way{}(std::string_view(lhs), std::string_view(rhs)));
+		}
+		else if constexpr (is_ordering_op<Op> && (std::is_class_v<LType> || std::is_class_v<RType>) &&
+			std::three_way_comparable_with<LType, RType>) {
+			return ordering_holds<Op>(std::compare_three_way{}(lhs, rhs));
+		}
+		else {
+			return op(lhs, rhs);
+		}
+#else
+		return op(lhs, rhs);
+#endif
+	}
+
+#if defined(CMP_INSTRUMENT)
+	/*
+	 * Instrumentation of the chain evaluations, compiled only when CMP_INSTRUMENT
+	 * is defined. The call site of a chain is the place of its "<<" or ">>",
+	 * taken by "std::source_location". For each site it counts the evaluations,
+	 * the true results, the comparisons done and the link at which the false
+	 * results stopped, e.g. "fails[1]" is the count of "lo < x < hi" failing at "x < hi".
+	 * Each thread counts into its own table, no lock or read-modify-write is taken
+	 * while counting. "report" and "report_json" merge the tables of all threads.
+	 */
+	namespace instrument {
+
+		constexpr std::size_t max_links = 16; // Failures at the later links are counted in the last one
+		constexpr std::size_t sites_per_thread = 256; // Sites beyond are counted as a single unknown site
+
+		// The root of a chain together with the place it is used
+		template<typename Root>
+		struct Call_site {
+			Root root;
+			std::source_location site;
+
+			constexpr Call_site(Root root, std::source_location site = std::source_location::current()) :
+				root(root), site(site) {}
+		};
+
+		// Written only by the owner thread, the atomics only make the reads of "report" safe
+		struct Counters {
+			std::atomic<std::uint64_t> calls{ 0 };
+			std::atomic<std::uint64_t> holds{ 0 };
+			std::atomic<std::uint64_t> comparisons{ 0 };
+			std::atomic<std::uint64_t> fails[max_links] = {};
+
+			static void add(std::atomic<std::uint64_t>& counter, std::uint64_t count) {
+				counter.store(counter.load(std::memory_order_relaxed) + count, std::memory_order_relaxed);
+			}
+		};
+
+		// Merged counters of a call site
+		struct Site_stats {
+			std::string file;
+			std::string function;
+			std::uint_least32_t line = 0;
+			std::uint_least32_t column = 0;
+			std::uint64_t calls = 0;
+			std::uint64_t holds = 0;
+			std::uint64_t comparisons = 0;
+			std::array<std::uint64_t, max_links> fails{};
+		};
+
+		class Thread_table;
+
+		class Registry {
+		public:
+			static Registry& instance() {
+				static Registry registry;
+				return registry;
+			}
+
+			void attach(const Thread_table* table) {
+				std::lock_guard<std::mutex> lock(mutex_);
+				tables_.push_back(table);
+			}
+
+			// The counts of a finishing thread are kept
+			void detach(const Thread_table* table);
+
+			std::vector<Site_stats> snapshot();
+
+		private:
+			using key_type = std::tuple<std::string, std::uint_least32_t, std::uint_least32_t, std::string>;
+
+			static void merge(std::map<key_type, Site_stats>& sites, const Thread_table& table);
+
+			std::mutex mutex_;
+			std::vector<const Thread_table*> tables_;
+			std::map<key_type, Site_stats> retired_;
+		};
+
+		class Thread_table {
+		public:
+			struct Slot {
+				std::atomic<bool> used{ false }; // Published after "site"
+				std::source_location site;
+				Counters counters;
+			};
+
+			Thread_table() { Registry::instance().attach(this); }
+			~Thread_table() { Registry::instance().detach(this); }
+			Thread_table(const Thread_table&) = delete;
+			Thread_table& operator=(const Thread_table&) = delete;
+
+			static Thread_table& local() {
+				thread_local Thread_table table;
+				return table;
+			}
+
+			/*
+			 * Open addressing by the address of the function name, the line and the column.
+			 * Each instantiation of a function template is a site of its own.
+			 */
+			Counters& counters(const std::source_location& site) {
+				const std::size_t hash = (reinterpret_cast<std::uintptr_t>(site.function_name()) >> 4) ^
+					(std::size_t(site.line()) * 0x9E3779B1u) ^ site.column();
+				for (std::size_t probe = 0; probe < sites_per_thread; ++probe) {
+					Slot& slot = slots_[(hash + probe) % sites_per_thread];
+					if (!slot.used.load(std::memory_order_relaxed)) {
+						slot.site = site;
+						slot.used.store(true, std::memory_order_release);
+						return slot.counters;
+					}
+					if (slot.site.function_name() == site.function_name() && slot.site.line() == site.line() &&
+						slot.site.column() == site.column())
+						return slot.counters;
+				}
+				overflow_.used.store(true, std::memory_order_release);
+				return overflow_.counters;
+			}
+
+			template<typename Visit>
+			void visit(Visit visit) const {
+				for (std::size_t inx = 0; inx < sites_per_thread; ++inx)
+					if (slots_[inx].used.load(std::memory_order_acquire))
+						visit(slots_[inx]);
+				if (overflow_.used.load(std::memory_order_acquire))
+					visit(overflow_);
+			}
+
+		private:
+			std::unique_ptr<Slot[]> slots_{ new Slot[sites_per_thread] };
+			Slot overflow_; // Its site is the default, an empty file name
+		};
+
+		inline void Registry::merge(std::map<key_type, Site_stats>& sites, const Thread_table& table) {
+			table.visit([&](const Thread_table::Slot& slot) {
+				Site_stats& stats = sites[key_type(slot.site.file_name(), slot.site.line(), slot.site.column(), slot.site.function_name())];
+				if (stats.calls == 0) {
+					stats.file = slot.site.file_name();
+					stats.function = slot.site.function_name();
+					stats.line = slot.site.line();
+					stats.column = slot.site.column();
+				}
+				stats.calls += slot.counters.calls.load(std::memory_order_relaxed);
+				stats.holds += slot.counters.holds.load(std::memory_order_relaxed);
+				stats.comparisons += slot.counters.comparisons.load(std::memory_order_relaxed);
+				for (std::size_t inx = 0; inx < max_links; ++inx)
+					stats.fails[inx] += slot.counters.fails[inx].load(std::memory_order_relaxed);
+			});
+		}
+
+		inline void Registry::detach(const Thread_table* table) {
+			std::lock_guard<std::mutex> lock(mutex_);
+			merge(retired_, *table);
+			tables_.erase(std::find(tables_.begin(), tables_.end(), table));
+		}
+
+		inline std::vector<Site_stats> Registry::snapshot() {
+			std::lock_guard<std::mutex> lock(mutex_);
+			std::map<key_type, Site_stats> sites = retired_;
+			for (const Thread_table* table : tables_)
+				merge(sites, *table);
+			std::vector<Site_stats> result;
+			result.reserve(sites.size());
+			for (auto& site : sites)
+				result.push_back(std::move(site.second));
+			return result;
+		}
+
+		/*
+		 * Counts a single evaluation. "link" is called with the result of each
+		 * comparison and its link index, "finish" with the result of the chain.
+		 */
+		class Probe {
+		public:
+			explicit Probe(const std::source_location& site) : site_(site) {}
+
+			bool link(std::size_t inx, bool holds) {
+				++comparisons_;
+				if (!holds)
+					failed_ = std::min(failed_, inx);
+				return holds;
+			}
+
+			bool finish(bool result) const {
+				Counters& counters = Thread_table::local().counters(site_);
+				Counters::add(counters.calls, 1);
+				Counters::add(counters.holds, result);
+				Counters::add(counters.comparisons, comparisons_);
+				if (failed_ != none)
+					Counters::add(counters.fails[std::min(failed_, max_links - 1)], 1);
+				return result;
+			}
+
+		private:
+			static constexpr std::size_t none = std::numeric_limits<std::size_t>::max();
+
+			const std::source_location& site_;
+			std::uint64_t comparisons_ = 0;
+			std::size_t failed_ = none;
+		};
+
+		// Merged counters of all of the threads, ordered by file, line and column
+		inline std::vector<Site_stats> snapshot() {
+			return Registry::instance().snapshot();
+		}
+
+		// One line per call site, e.g. "main.cpp:12:8 calls=100 true=40 comparisons=1.60 fails=[10 50]"
+		inline void report(std::ostream& out) {
+			for (const Site_stats& stats : snapshot()) {
+				std::size_t links = max_links;
+				while (links > 1 && stats.fails[links - 1] == 0)
+					--links;
+				out << (stats.file.empty() ? "<other sites>" : stats.file) << ':' << stats.line << ':' << stats.column <<
+					' ' << stats.function << " calls=" << stats.calls << " true=" << stats.holds << " comparisons=" <<
+					(stats.calls ? double(stats.comparisons) / double(stats.calls) : 0.0) << " fails=[";
+				for (std::size_t inx = 0; inx < links; ++inx)
+					out << (inx ? " " : "") << stats.fails[inx];
+				out << "]\n";
+			}
+		}
+
+		// An array of an object per call site, "fails" is indexed by the link
+		inline void report_json(std::ostream& out) {
+			auto quoted = [&out](const std::string& text) {
+				out << '"';
+				for (char ch : text) {
+					if (ch == '"' || ch == '\\')
+						out << '\\' << ch;
+					else if (static_cast<unsigned char>(ch) < 0x20)
+						out << ' ';
+					else
+						out << ch;
+				}
+				out << '"';
+			};
+			out << '[';
+			bool first = true;
+			for (const Site_stats& stats : snapshot()) {
+				out << (first ? "\n" : ",\n") << "  {\"file\": ";
+				quoted(stats.file);
+				out << ", \"line\": " << stats.line << ", \"column\": " << stats.column << ", \"function\": ";
+				quoted(stats.function);
+				out << ", \"calls\": " << stats.calls << ", \"true\": " << stats.holds <<
+					", \"comparisons\": " << stats.comparisons << ", \"fails\": [";
+				for (std::size_t inx = 0; inx < max_links; ++inx)
+					out << (inx ? ", " : "") << stats.fails[inx];
+				out << "]}";
+				first = false;
+			}
+			out << "\n]\n";
+		}
+	}
+#endif
+
+	/*
+	 * Storage of a chain operand. Small trivially copyable operands, up to two
+	 * machine words, are stored by value. So a stored chain does not refer to
+	 * a temporary like "2 * y" and its operands can be kept in registers.
+	 * Large or non-copyable operands are stored by reference.
+	 */
+	template<typename T, typename Value = std::decay_t<const std::remove_reference_t<T>>>
+	using storage_t = std::conditional_t<
+		std::is_trivially_copyable<Value>::value && sizeof(Value) <= 2 * sizeof(void*),
+		Value, const std::remove_reference_t<T>&>;
+
+	// The deprecation warning is the diagnostic of an always false chain
+	template<typename Chain>
+	[[deprecated("Always false comparison chain, its constant operands contradict")]]
+	constexpr bool always_false() { return false; }
+
 	template<
 		std::size_t Index, // Chain node index number
 		class Parent, // Type of the parent node which generated this
-		class OpType, // Preceding operator class type : std::less<> OR std::less_equal<>
+		class OpType, // Preceding operator class type : std::less<>, std::less_equal<>, std::greater<> OR std::greater_equal<>
 		typename T // Type of the comparison argument stored by this node 
 	>
 	class Node : public Parent {
 	public:
 		using this_type = Node<Index, Parent, OpType, T>;
 		using parent = Parent;
-		const T& elem;
+		using operator_type = OpType;
+		using chain_order = typename parent::chain_order;
+		using storage_type = storage_t<T>;
+		storage_type elem;
 
-		Node(const Node& node) = default;
-		Node(Parent&& pclass, T&& elem) : parent(pclass), elem(elem) {}
-		Node(T&& elem) : elem(elem) {}
+		static constexpr bool descending = std::is_same<chain_order, Order::Descending>::value;
+		using strict_op = std::conditional_t<descending, std::greater<>, std::less<>>;
+		using non_strict_op = std::conditional_t<descending, std::greater_equal<>, std::less_equal<>>;
 
+		static constexpr bool transitive = parent::transitive && is_transitive<std::decay_t<T>>::value;
+
+		// A strict link exists between the last constant operand and this one
+		static constexpr bool strict_link = parent::strict_since_constant || std::is_same<OpType, strict_op>::value;
+		static constexpr bool strict_since_constant = !is_constant<std::decay_t<T>>::value && strict_link;
+		static constexpr bool contradiction = parent::contradiction || !(descending ?
+			is_ordered<std::decay_t<T>, typename parent::last_constant, strict_link>::value :
+			is_ordered<typename parent::last_constant, std::decay_t<T>, strict_link>::value);
+		using last_constant = std::conditional_t<is_constant<std::decay_t<T>>::value,
+			std::decay_t<T>, typename parent::last_constant>;
+
+		using strategy = std::conditional_t<transitive && contradiction, Strategy::AlwaysFalse,
+			strategy_for<typename parent::evaluation, transitive>>;
+
+		constexpr Node(const Node& node) = default;
+		constexpr Node(Parent&& pclass, T&& elem) : parent(pclass), elem(elem) {}
+		constexpr Node(T&& elem) : elem(elem) {}
+
+		// "<" and "<=" are only allowed for an ascending chain, ">" and ">=" for a descending one
 		template<typename RType>
-		auto operator<(RType&& rhs) {
+		constexpr auto operator<(RType&& rhs) {
+			static_assert(!descending, "Ambiguously ordered comparison chain");
 			return Node<Index + 1, this_type, std::less<>, RType>(std::move(*this), std::forward<RType>(rhs));
 		}
 
 		template<typename RType>
-		auto operator<=(RType&& rhs) {
+		constexpr auto operator<=(RType&& rhs) {
+			static_assert(!descending, "Ambiguously ordered comparison chain");
 			return Node<Index + 1, this_type, std::less_equal<>, RType>(std::move(*this), std::forward<RType>(rhs));
 		}
 
+		template<typename RType>
+		constexpr auto operator>(RType&& rhs) {
+			static_assert(descending, "Ambiguously ordered comparison chain");
+			return Node<Index + 1, this_type, std::greater<>, RType>(std::move(*this), std::forward<RType>(rhs));
+		}
+
+		template<typename RType>
+		constexpr auto operator>=(RType&& rhs) {
+			static_assert(descending, "Ambiguously ordered comparison chain");
+			return Node<Index + 1, this_type, std::greater_equal<>, RType>(std::move(*this), std::forward<RType>(rhs));
+		}
+
 		static constexpr std::size_t size() { return Index + 1; }
 
+		template<std::size_t Inx, typename P, typename O, typename U>
+		static constexpr const Node<Inx, P, O, U>& node_at(const Node<Inx, P, O, U>& node) { return node; }
+
 		using parent::get;
-		const T& get(Element<Index>) const { return elem; }
+		constexpr const storage_type& get(Element<Index>) const { return elem; }
 
 		using parent::op;
-		OpType op(Element<Index>) const { return{}; }
+		constexpr OpType op(Element<Index>) const { return{}; }
 
 		template<std::size_t Inx>
-		decltype(auto) get() { return (get(Element<Inx>{})); }
+		constexpr decltype(auto) get() const { return (node_at<Inx>(*this).elem); }
 
 		template<std::size_t Inx>
-		decltype(auto) op() { return op(Element<Inx>{}); }
+		constexpr decltype(auto) op() const { return typename std::decay_t<decltype(node_at<Inx>(*this))>::operator_type{}; }
 
-		/* The range is including Final */
-		template<std::size_t Current, std::size_t Step, std::size_t Final, typename Func>
-		std::enable_if_t<(Current <= Final)> for_helper(Func func) {
-			func(get<Current>());
-			for_helper<Current + Step, Step, Final>(func);
-		};
-		template<std::size_t Current, std::size_t Step, std::size_t Final, typename Func>
-		std::enable_if_t<(Current > Final)> for_helper(Func func) {};
+		template<typename Func, std::size_t... Inx>
+		constexpr void foreach(Func func, std::index_sequence<Inx...>) const {
+			(func(get<Inx>()), ...);
+		}
 
 		template<typename Func>
-		void foreach(Func func) {
-			for_helper<0, 1, size() - 1>(func);
+		constexpr void foreach(Func func) const {
+			foreach(func, std::make_index_sequence<size()>{});
 		}
 
+		// op<LIndex + 1>() ... op<RIndex>() are the operators between LIndex and RIndex
+		template<std::size_t Inx>
+		using op_type = decltype(std::declval<const this_type&>().template op<Inx>());
 
-		template<std::size_t LIndex, std::size_t RIndex>
-		std::enable_if_t<(LIndex < RIndex), bool> check_all_less_equal() {
-			// op<LIndex + 1>() is the succeeding operator
-			if (std::is_same<decltype(op<LIndex + 1>()), std::less_equal<>>::value) {
-				return check_all_less_equal<LIndex + 1, RIndex>();
-			}
-			return false;
+		template<std::size_t LIndex, std::size_t... Inx>
+		static constexpr bool check_all_non_strict(std::index_sequence<Inx...>) {
+			return (std::is_same<op_type<LIndex + 1 + Inx>, non_strict_op>::value && ...);
 		}
+
 		template<std::size_t LIndex, std::size_t RIndex>
-		std::enable_if_t<(LIndex >= RIndex), bool> check_all_less_equal() {
-			return true;
+		static constexpr bool check_all_non_strict() {
+			return check_all_non_strict<LIndex>(std::make_index_sequence<RIndex - LIndex>{});
 		}
 
 		template<std::size_t LIndex, std::size_t RIndex>
-		bool compare() {
-			if (check_all_less_equal<LIndex, RIndex>()) {
-				return std::less_equal<>{}(get<LIndex>(), get<RIndex>());
+		constexpr bool compare() const {
+			if constexpr (check_all_non_strict<LIndex, RIndex>()) {
+				return link_compare(non_strict_op{}, value_of(get<LIndex>()), value_of(get<RIndex>()));
 			}
 			else {
-				return std::less<>{}(get<LIndex>(), get<RIndex>());
+				return link_compare(strict_op{}, value_of(get<LIndex>()), value_of(get<RIndex>()));
 			}
 		}
 
-		template<std::size_t LIndex, std::size_t Dist>
-		std::enable_if_t<(LIndex + Dist < size()), bool> eval_for_dist() {
-			return compare<LIndex, LIndex + Dist>() && eval_for_dist<LIndex + 1, Dist>();
+		template<std::size_t Dist, std::size_t... LIndex>
+		constexpr bool eval_for_dist(std::index_sequence<LIndex...>) const {
+			return (compare<LIndex, LIndex + Dist>() && ...);
 		}
-		template<std::size_t LIndex, std::size_t Dist>
-		std::enable_if_t<(LIndex + Dist >= size()), bool> eval_for_dist() {
-			return true;
+
+		template<std::size_t... Dist>
+		constexpr bool eval_all_pairs(std::index_sequence<Dist...>) const {
+			return (eval_for_dist<Dist + 1>(std::make_index_sequence<size() - Dist - 1>{}) && ...);
 		}
 
-		template<std::size_t Dist = 1>
-		std::enable_if_t<(Dist < size()), bool> evaluate() {
-			return eval_for_dist<0, Dist>() && evaluate<Dist + 1>();
+		// op<LIndex + 1>() is the operator between the adjacent operands
+		template<std::size_t... LIndex>
+		constexpr bool eval_adjacent(std::index_sequence<LIndex...>) const {
+			return (link_compare(op<LIndex + 1>(), value_of(get<LIndex>()), value_of(get<LIndex + 1>())) && ...);
 		}
-		template<std::size_t Dist>
-		std::enable_if_t<(Dist >= size()), bool> evaluate() {
-			return true;
+
+		template<std::size_t... LIndex>
+		constexpr bool eval_branchless(std::index_sequence<LIndex...>) const {
+			return (true & ... & link_compare(op<LIndex + 1>(), value_of(get<LIndex>()), value_of(get<LIndex + 1>())));
+		}
+
+		constexpr bool eval_all_pairs() const { return eval_all_pairs(std::make_index_sequence<size() - 1>{}); }
+		constexpr bool eval_adjacent() const { return eval_adjacent(std::make_index_sequence<size() - 1>{}); }
+		constexpr bool eval_branchless() const { return eval_branchless(std::make_index_sequence<size() - 1>{}); }
+
+		constexpr bool evaluate(Strategy::Adjacent) const { return eval_adjacent(); }
+		constexpr bool evaluate(Strategy::AllPairs) const { return eval_all_pairs(); }
+		constexpr bool evaluate(Strategy::Branchless) const { return eval_branchless(); }
+		constexpr bool evaluate(Strategy::AlwaysFalse) const { return always_false<this_type>(); }
+
+#if defined(CMP_INSTRUMENT)
+		// The same evaluations, each comparison reported to the probe
+		template<std::size_t Dist, std::size_t... LIndex>
+		bool eval_for_dist(instrument::Probe& probe, std::index_sequence<LIndex...>) const {
+			return (probe.link(LIndex + Dist - 1, compare<LIndex, LIndex + Dist>()) && ...);
+		}
+
+		template<std::size_t... Dist>
+		bool eval_all_pairs(instrument::Probe& probe, std::index_sequence<Dist...>) const {
+			return (eval_for_dist<Dist + 1>(probe, std::make_index_sequence<size() - Dist - 1>{}) && ...);
+		}
+
+		template<std::size_t... LIndex>
+		bool eval_adjacent(instrument::Probe& probe, std::index_sequence<LIndex...>) const {
+			return (probe.link(LIndex, link_compare(op<LIndex + 1>(), value_of(get<LIndex>()), value_of(get<LIndex + 1>()))) && ...);
+		}
+
+		template<std::size_t... LIndex>
+		bool eval_branchless(instrument::Probe& probe, std::index_sequence<LIndex...>) const {
+			return (true & ... & probe.link(LIndex, link_compare(op<LIndex + 1>(), value_of(get<LIndex>()), value_of(get<LIndex + 1>()))));
 		}
 
-		operator bool() {
+		bool evaluate(instrument::Probe& probe, Strategy::Adjacent) const {
+			return eval_adjacent(probe, std::make_index_sequence<size() - 1>{});
+		}
+		bool evaluate(instrument::Probe& probe, Strategy::AllPairs) const {
+			return eval_all_pairs(probe, std::make_index_sequence<size() - 1>{});
+		}
+		bool evaluate(instrument::Probe& probe, Strategy::Branchless) const {
+			return eval_branchless(probe, std::make_index_sequence<size() - 1>{});
+		}
+		bool evaluate(instrument::Probe&, Strategy::AlwaysFalse) const { return always_false<this_type>(); }
+
+		bool evaluate_probed() const {
+			instrument::Probe probe(this->site_);
+			return probe.finish(evaluate(probe, strategy{}));
+		}
+#endif
+
+		constexpr bool evaluate() const {
+#if defined(CMP_INSTRUMENT)
+			if (!std::is_constant_evaluated())
+				return evaluate_probed();
+#endif
+			return evaluate(strategy{});
+		}
+
+		constexpr operator bool() const {
 			return evaluate();
 		}
 
 	};
 
+	template<typename Policy, typename ChainOrder>
 	struct Root_node { 
+		using evaluation = Policy;
+		using chain_order = ChainOrder;
 		void get() {}; // This function is required by "using parent::get"
 		void op() {}; // This function is required by "using parent::op"
+		static constexpr bool transitive = true;
+		static constexpr bool strict_since_constant = false;
+		static constexpr bool contradiction = false;
+		using last_constant = void;
+#if defined(CMP_INSTRUMENT)
+		std::source_location site_{}; // Set by the chain root
+#endif
 	};
 
+	/*
+	 * "<<" starts an ascending chain of "<" and "<=",
+	 * ">>" starts a descending chain of ">" and ">=", e.g. cmp::chain_root >> 15 > x >= 5.
+	 * Mixing the directions is a compile time error.
+	 */
+	template<typename Policy = Evaluation::ShortCircuit>
 	class Chain_root {
 	public:
+#if !defined(CMP_INSTRUMENT)
+		template<typename RType>
+		constexpr auto operator<<(RType&& rhs) const {
+			return Node<0, cmp::Root_node<Policy, Order::Ascending>, void, RType>(std::forward<RType>(rhs));
+		}
+
+		template<typename RType>
+		constexpr auto operator>>(RType&& rhs) const {
+			return Node<0, cmp::Root_node<Policy, Order::Descending>, void, RType>(std::forward<RType>(rhs));
+		}
+#else
+		// The root converts to a "Call_site" at the place of the chain
+		template<typename RType>
+		friend constexpr auto operator<<(instrument::Call_site<Chain_root> root, RType&& rhs) {
+			auto node = Node<0, cmp::Root_node<Policy, Order::Ascending>, void, RType>(std::forward<RType>(rhs));
+			node.site_ = root.site;
+			return node;
+		}
+
 		template<typename RType>
-		auto operator<<(RType&& rhs) {
-			return Node<0, cmp::Root_node, void, RType>(std::forward<RType>(rhs));
+		friend constexpr auto operator>>(instrument::Call_site<Chain_root> root, RType&& rhs) {
+			auto node = Node<0, cmp::Root_node<Policy, Order::Descending>, void, RType>(std::forward<RType>(rhs));
+			node.site_ = root.site;
+			return node;
 		}
+#endif
 	};
 	
-	Chain_root chain_root{};
+	/*
+	 * "chain_root" is constexpr, so a chain of constant operands is a constant expression.
+	 * e.g. static_assert(cmp::chain_root << 1 < 2 <= 2, "");
+	 */
+	constexpr Chain_root<> chain_root{};
+	constexpr Chain_root<Evaluation::Branchless> branchless_root{};
 	
 
 	//##########################################################################3
@@ -172,13 +798,6 @@ namespace cmp {
 
 
 
-	// Helper type for controlling of the chain order
-	struct Order {
-		struct Ascending;
-		struct Descending;
-	};
-
-
 	struct Operation {
 		struct Base {};
 		struct ChainBegin {};
@@ -193,12 +812,13 @@ namespace cmp {
 	// Operation::Base
 	template<typename RType, typename OperType>
 	struct Reserve {
-		const RType& rhs_;
+		storage_t<RType> rhs_;
 		typedef RType r_type;
 
 		Reserve() : rhs_() {}
-		Reserve(const RType& rhs) : rhs_(rhs) {}
-		Reserve(const Reserve& reserve) : rhs_(reserve.rhs_) {}
+		constexpr Reserve(const RType& rhs) : rhs_(rhs) {}
+		constexpr Reserve(const Reserve&) = default;
+		constexpr Reserve(Reserve&&) = default;
 	};
 
 	template<typename RType>
@@ -209,8 +829,9 @@ namespace cmp {
 		typedef typename Operation::ChainBegin oper_type;
 
 		Reserve() : super() {}
-		Reserve(const RType& rhs) : super(rhs) {}
-		Reserve(const Reserve& reserve) : super(reserve) {}
+		constexpr Reserve(const RType& rhs) : super(rhs) {}
+		constexpr Reserve(const Reserve&) = default;
+		constexpr Reserve(Reserve&&) = default;
 	};
 
 	template<typename RType>
@@ -221,69 +842,509 @@ namespace cmp {
 		typedef typename Operation::LowerThan oper_type;
 
 		Reserve() : super() {}
-		Reserve(const RType& rhs) : super(rhs) {}
-		Reserve(const Reserve& reserve) : super(reserve) {}
+		constexpr Reserve(const RType& rhs) : super(rhs) {}
+		constexpr Reserve(const Reserve&) = default;
+		constexpr Reserve(Reserve&&) = default;
+	};
+
+	template<typename RType>
+	class Reserve<RType, Operation::LowerThanEqual> :
+		public Reserve<RType, Operation::Base> {
+		using super = Reserve<RType, Operation::Base>;
+	public:
+		typedef typename Operation::LowerThanEqual oper_type;
+
+		Reserve() : super() {}
+		constexpr Reserve(const RType& rhs) : super(rhs) {}
+		constexpr Reserve(const Reserve&) = default;
+		constexpr Reserve(Reserve&&) = default;
+	};
+
+	template<typename RType>
+	class Reserve<RType, Operation::GreaterThan> :
+		public Reserve<RType, Operation::Base> {
+		using super = Reserve<RType, Operation::Base>;
+	public:
+		typedef typename Operation::GreaterThan oper_type;
+
+		Reserve() : super() {}
+		constexpr Reserve(const RType& rhs) : super(rhs) {}
+		constexpr Reserve(const Reserve& reserve) : super(reserve) {}
+	};
+
+	template<typename RType>
+	class Reserve<RType, Operation::GreaterThanEqual> :
+		public Reserve<RType, Operation::Base> {
+		using super = Reserve<RType, Operation::Base>;
+	public:
+		typedef typename Operation::GreaterThanEqual oper_type;
+
+		Reserve() : super() {}
+		constexpr Reserve(const RType& rhs) : super(rhs) {}
+		constexpr Reserve(const Reserve& reserve) : super(reserve) {}
 	};
 
 	template<typename LType, typename RType>
-	bool compare(const LType& lhs, Reserve<RType, Operation::LowerThan>& rhs) {
-		return lhs < rhs.rhs_;
+	constexpr bool compare(const LType& lhs, const Reserve<RType, Operation::LowerThan>& rhs) {
+		return link_compare(std::less<>{}, value_of(lhs), value_of(rhs.rhs_));
 	}
 
 	template<typename LType, typename RType>
-	bool compare(const LType& lhs, Reserve<RType, Operation::LowerThanEqual>& rhs) {
-		return lhs <= rhs.rhs_;
+	constexpr bool compare(const LType& lhs, const Reserve<RType, Operation::LowerThanEqual>& rhs) {
+		return link_compare(std::less_equal<>{}, value_of(lhs), value_of(rhs.rhs_));
 	}
 
-	template<std::size_t OuterInx, std::size_t InnerInx, std::size_t EndInx, typename... Types>
-	class Implement {
-	public:
-		static bool comparison(const std::tuple<Types...>& tuple) {
-			auto first = std::get<OuterInx>(tuple);
-			auto second = std::get<InnerInx>(tuple);
-			return compare(first.rhs_, second) &&
-				Implement<OuterInx, InnerInx + 1, EndInx, Types...>::comparison(tuple);
-		}
+	template<typename LType, typename RType>
+	constexpr bool compare(const LType& lhs, const Reserve<RType, Operation::GreaterThan>& rhs) {
+		return link_compare(std::greater<>{}, value_of(lhs), value_of(rhs.rhs_));
+	}
+
+	template<typename LType, typename RType>
+	constexpr bool compare(const LType& lhs, const Reserve<RType, Operation::GreaterThanEqual>& rhs) {
+		return link_compare(std::greater_equal<>{}, value_of(lhs), value_of(rhs.rhs_));
+	}
+
+	/*
+	 * Contradiction of the constant operands of "Reserves", checked as "Node" checks
+	 * them: "LastConstant" is the type of the last constant so far, "StrictSince" is
+	 * true if a strict link follows it.
+	 */
+	template<bool Descending, typename LastConstant, bool StrictSince, typename... Reserves>
+	struct contradicts : std::false_type {};
+
+	template<bool Descending, typename LastConstant, bool StrictSince, typename Reserve_type, typename... Rest>
+	struct contradicts<Descending, LastConstant, StrictSince, Reserve_type, Rest...> {
+		using type = std::decay_t<typename Reserve_type::r_type>;
+		using oper_type = typename Reserve_type::oper_type;
+		static constexpr bool strict_link = StrictSince || std::is_same<oper_type, Operation::LowerThan>::value ||
+			std::is_same<oper_type, Operation::GreaterThan>::value;
+		static constexpr bool value = !(Descending ?
+			is_ordered<type, LastConstant, strict_link>::value : is_ordered<LastConstant, type, strict_link>::value) ||
+			contradicts<Descending, std::conditional_t<is_constant<type>::value, type, LastConstant>,
+				!is_constant<type>::value && strict_link, Rest...>::value;
 	};
 
-	template<std::size_t OuterInx, std::size_t EndInx, typename... Types>
-	class Implement<OuterInx, EndInx, EndInx, Types...> {
-	public:
-		static bool comparison(const std::tuple<Types...>& tuple) {
-			auto first = std::get<OuterInx>(tuple);
-			auto second = std::get<EndInx>(tuple);
-			return compare(first.rhs_, second) &&
-				Implement<OuterInx + 1, OuterInx + 2, EndInx, Types...>::comparison(tuple);
-		}
+	/*
+	 * Operands of a "Conductor". Each "Reserve" is kept in its own indexed base
+	 * class, so "reserve_at" finds a slot without recursion. A temporary
+	 * Conductor, every one in the middle of a chain expression, moves its
+	 * Reserves into the store of the next one by "take_at". A Reserve is a
+	 * reference or a small trivially copyable value with defaulted copy and
+	 * move constructors, so a store is trivially moved and the operands
+	 * themselves are never copied.
+	 */
+	template<std::size_t Inx, typename Reserve_type>
+	struct Reserve_slot {
+		Reserve_type reserve_;
 	};
 
-	template<std::size_t InnerInx, std::size_t EndInx, typename... Types>
-	class Implement<EndInx, InnerInx, EndInx, Types...> {
-	public:
-		static bool comparison(const std::tuple<Types...>& tuple) {
-			return true;
-		}
+	template<typename Indices, typename... Types>
+	struct Reserve_store;
+
+	template<std::size_t... Inx, typename... Types>
+	struct Reserve_store<std::index_sequence<Inx...>, Types...> : Reserve_slot<Inx, Types>... {
+		constexpr Reserve_store(const Types&... reserves) : Reserve_slot<Inx, Types>{ reserves }... {}
+		constexpr Reserve_store(Types&&... reserves) : Reserve_slot<Inx, Types>{ std::move(reserves) }... {}
 	};
 
+	template<std::size_t Inx, typename Reserve_type>
+	constexpr const Reserve_type& reserve_at(const Reserve_slot<Inx, Reserve_type>& slot) {
+		return slot.reserve_;
+	}
+
+	template<std::size_t Inx, typename Reserve_type>
+	constexpr Reserve_type&& take_at(Reserve_slot<Inx, Reserve_type>& slot) {
+		return std::move(slot.reserve_);
+	}
 
 	/*
-	 * "Conductor" object preserves information before and transfers it to the following.
-	 * Operations should follow chain order.
-	 * Ascending to ascending or descending to descending.
-	 * Breaking the order will result in a compile time error.
-	 * Mixes comparison order is not allowed.
-	 * Internal state is constant after construction.
+	 * "AllPairs" compares each operand with all of the succeeding operands,
+	 * by the operation of the succeeding one.
+	 * "Adjacent" compares each operand only with the next one.
+	 * "AlwaysFalse" compares nothing, the constants of the chain contradict.
 	 */
-	template<typename ChainOrder, std::size_t OperCnt, typename... Previous>
-	class Conductor {
+	template<typename... Types>
+	class Implement {
+		using store_type = Reserve_store<std::index_sequence_for<Types...>, Types...>;
+
+		template<std::size_t... Inx>
+		static constexpr bool compare_adjacent(const store_type& store, std::index_sequence<Inx...>) {
+			return (compare(reserve_at<Inx>(store).rhs_, reserve_at<Inx + 1>(store)) && ...);
+		}
+
+		template<std::size_t... Inx>
+		static constexpr bool compare_branchless(const store_type& store, std::index_sequence<Inx...>) {
+			return (true & ... & compare(reserve_at<Inx>(store).rhs_, reserve_at<Inx + 1>(store)));
+		}
+
+		template<std::size_t OuterInx, std::size_t... InnerInx>
+		static constexpr bool compare_from(const store_type& store, std::index_sequence<InnerInx...>) {
+			return (compare(reserve_at<OuterInx>(store).rhs_, reserve_at<OuterInx + 1 + InnerInx>(store)) && ...);
+		}
+
+		template<std::size_t... OuterInx>
+		static constexpr bool compare_all(const store_type& store, std::index_sequence<OuterInx...>) {
+			return (compare_from<OuterInx>(store, std::make_index_sequence<sizeof...(Types) - OuterInx - 1>{}) && ...);
+		}
+
 	public:
-		std::tuple<Previous...> previous_;
+		static constexpr bool comparison(const store_type& store, Strategy::AllPairs) {
+			return compare_all(store, std::index_sequence_for<Types...>{});
+		}
 
-		template<typename... Types>
-		Conductor(std::tuple<Types...> previous) : previous_(previous) {}
+		static constexpr bool comparison(const store_type& store, Strategy::Adjacent) {
+			return compare_adjacent(store, std::make_index_sequence<sizeof...(Types) - 1>{});
+		}
 
-		/*
-		 * These operators are only allowed for an "Ascending" ordered comparison chain.
+		static constexpr bool comparison(const store_type& store, Strategy::Branchless) {
+			return compare_branchless(store, std::make_index_sequence<sizeof...(Types) - 1>{});
+		}
+
+		static constexpr bool comparison(const store_type&, Strategy::AlwaysFalse) {
+			return always_false<Implement>();
+		}
+
+#if defined(CMP_INSTRUMENT)
+	private:
+		template<std::size_t... Inx>
+		static bool compare_adjacent(const store_type& store, instrument::Probe& probe, std::index_sequence<Inx...>) {
+			return (probe.link(Inx, compare(reserve_at<Inx>(store).rhs_, reserve_at<Inx + 1>(store))) && ...);
+		}
+
+		template<std::size_t... Inx>
+		static bool compare_branchless(const store_type& store, instrument::Probe& probe, std::index_sequence<Inx...>) {
+			return (true & ... & probe.link(Inx, compare(reserve_at<Inx>(store).rhs_, reserve_at<Inx + 1>(store))));
+		}
+
+		template<std::size_t OuterInx, std::size_t... InnerInx>
+		static bool compare_from(const store_type& store, instrument::Probe& probe, std::index_sequence<InnerInx...>) {
+			return (probe.link(OuterInx + InnerInx,
+				compare(reserve_at<OuterInx>(store).rhs_, reserve_at<OuterInx + 1 + InnerInx>(store))) && ...);
+		}
+
+		template<std::size_t... OuterInx>
+		static bool compare_all(const store_type& store, instrument::Probe& probe, std::index_sequence<OuterInx...>) {
+			return (compare_from<OuterInx>(store, probe, std::make_index_sequence<sizeof...(Types) - OuterInx - 1>{}) && ...);
+		}
+
+	public:
+		// The same comparisons, each one reported to the probe
+		static bool comparison(const store_type& store, instrument::Probe& probe, Strategy::AllPairs) {
+			return compare_all(store, probe, std::index_sequence_for<Types...>{});
+		}
+
+		static bool comparison(const store_type& store, instrument::Probe& probe, Strategy::Adjacent) {
+			return compare_adjacent(store, probe, std::make_index_sequence<sizeof...(Types) - 1>{});
+		}
+
+		static bool comparison(const store_type& store, instrument::Probe& probe, Strategy::Branchless) {
+			return compare_branchless(store, probe, std::make_index_sequence<sizeof...(Types) - 1>{});
+		}
+
+		static bool comparison(const store_type&, instrument::Probe&, Strategy::AlwaysFalse) {
+			return always_false<Implement>();
+		}
+#endif
+	};
+
+
+	/*
+	 * Placeholders turn a comparison chain into a reusable "Predicate".
+	 * "arg<N>" is replaced by the N-th argument of the predicate call.
+	 * "_" is the short form of "arg<0>".
+	 */
+	template<std::size_t N>
+	struct Arg {};
+
+	template<std::size_t N>
+	constexpr Arg<N> arg{};
+
+	constexpr Arg<0> _{};
+
+	// Number of the predicate arguments required by an operand
+	template<typename T>
+	struct arity_of : std::integral_constant<std::size_t, 0> {};
+
+	template<std::size_t N>
+	struct arity_of<Arg<N>> : std::integral_constant<std::size_t, N + 1> {};
+
+	// Enables an operator of a chain for the operands other than a placeholder
+	template<typename RType>
+	using if_operand = std::enable_if_t<arity_of<RType>::value == 0>;
+
+	/*
+	 * Operand of a "Predicate". Unlike "Reserve", the operand is stored by value,
+	 * so the predicate can outlive the expression which built it.
+	 */
+	template<typename RType, typename OperType>
+	struct Capture {
+		static_assert(!is_lazy<RType>::value, "A lazy operand can not be stored by a predicate");
+		typedef RType r_type;
+		typedef OperType oper_type;
+		RType rhs_;
+	};
+
+	template<typename RType, typename OperType>
+	constexpr Capture<std::decay_t<RType>, OperType> make_capture(RType&& rhs, OperType) {
+		return{ std::forward<RType>(rhs) };
+	}
+
+	template<typename RType, typename OperType>
+	constexpr Capture<std::decay_t<const RType>, OperType> make_capture(const Reserve<RType, OperType>& reserve) {
+		return{ reserve.rhs_ };
+	}
+
+	template<typename T, typename Args>
+	constexpr const T& resolve(const T& operand, const Args&) {
+		return operand;
+	}
+
+	template<std::size_t N, typename Args>
+	constexpr decltype(auto) resolve(Arg<N>, const Args& args) {
+		return std::get<N>(args);
+	}
+
+	template<typename LType, typename RType>
+	constexpr bool compare(const LType& lhs, const RType& rhs, Operation::LowerThan) {
+		return link_compare(std::less<>{}, lhs, rhs);
+	}
+
+	template<typename LType, typename RType>
+	constexpr bool compare(const LType& lhs, const RType& rhs, Operation::LowerThanEqual) {
+		return link_compare(std::less_equal<>{}, lhs, rhs);
+	}
+
+	template<typename LType, typename RType>
+	constexpr bool compare(const LType& lhs, const RType& rhs, Operation::GreaterThan) {
+		return link_compare(std::greater<>{}, lhs, rhs);
+	}
+
+	template<typename LType, typename RType>
+	constexpr bool compare(const LType& lhs, const RType& rhs, Operation::GreaterThanEqual) {
+		return link_compare(std::greater_equal<>{}, lhs, rhs);
+	}
+
+	/*
+	 * "Predicate" is a comparison chain including placeholders.
+	 * It is built once and called for each set of arguments,
+	 * e.g. std::find_if(v.begin(), v.end(), cmp::chain << lo < cmp::_ <= hi).
+	 * Operands are compared only with their neighbours, the same as the
+	 * hand written "lo < x && x <= hi". The strategy is chosen by the types
+	 * of the resolved operands, a call with an argument of a non-transitive
+	 * type is evaluated by "AllPairs" as the chain of the same operands.
+	 * "Policy" is the evaluation policy of the chain's initiator, so
+	 * cmp::branchless_chain << lo < cmp::_ < hi evaluates by "Branchless".
+	 * A descending predicate is built the same way, e.g. cmp::chain >> hi > cmp::_ >= lo.
+	 */
+	template<typename ChainOrder, typename Policy, typename... Captures>
+	class Predicate {
+	public:
+		using chain_order = ChainOrder;
+		using policy = Policy;
+		std::tuple<Captures...> captures_;
+
+		constexpr Predicate(Captures&&... captures) : captures_(std::move(captures)...) {}
+
+		static constexpr std::size_t size() { return sizeof...(Captures); }
+
+		static constexpr std::size_t arity() {
+			return std::max({ std::size_t(0), arity_of<typename Captures::r_type>::value... });
+		}
+
+		/*
+		 * A temporary predicate (in the middle of a chain expression) hands its
+		 * captures over to the next one, so an operand is never copied twice.
+		 */
+		template<typename RType>
+		constexpr auto operator <(RType&& rhs) const & {
+			return Predicate(*this).append(make_capture(std::forward<RType>(rhs), Operation::LowerThan{}));
+		}
+		template<typename RType>
+		constexpr auto operator <(RType&& rhs) && {
+			return std::move(*this).append(make_capture(std::forward<RType>(rhs), Operation::LowerThan{}));
+		}
+
+		template<typename RType>
+		constexpr auto operator <=(RType&& rhs) const & {
+			return Predicate(*this).append(make_capture(std::forward<RType>(rhs), Operation::LowerThanEqual{}));
+		}
+		template<typename RType>
+		constexpr auto operator <=(RType&& rhs) && {
+			return std::move(*this).append(make_capture(std::forward<RType>(rhs), Operation::LowerThanEqual{}));
+		}
+
+		template<typename RType>
+		constexpr auto operator >(RType&& rhs) const & {
+			return Predicate(*this).append(make_capture(std::forward<RType>(rhs), Operation::GreaterThan{}));
+		}
+		template<typename RType>
+		constexpr auto operator >(RType&& rhs) && {
+			return std::move(*this).append(make_capture(std::forward<RType>(rhs), Operation::GreaterThan{}));
+		}
+
+		template<typename RType>
+		constexpr auto operator >=(RType&& rhs) const & {
+			return Predicate(*this).append(make_capture(std::forward<RType>(rhs), Operation::GreaterThanEqual{}));
+		}
+		template<typename RType>
+		constexpr auto operator >=(RType&& rhs) && {
+			return std::move(*this).append(make_capture(std::forward<RType>(rhs), Operation::GreaterThanEqual{}));
+		}
+
+		static constexpr bool descending = std::is_same<ChainOrder, Order::Descending>::value;
+
+		// "<" and "<=" are only allowed for an ascending chain, ">" and ">=" for a descending one
+		template<typename Capture_type>
+		constexpr auto append(Capture_type&& capture) && {
+			using oper_type = typename Capture_type::oper_type;
+			static_assert(descending == (std::is_same<oper_type, Operation::GreaterThan>::value ||
+				std::is_same<oper_type, Operation::GreaterThanEqual>::value), "Ambiguously ordered comparison chain");
+			return append(std::move(capture), std::index_sequence_for<Captures...>{});
+		}
+
+		template<typename Capture_type, std::size_t... Inx>
+		constexpr auto append(Capture_type&& capture, std::index_sequence<Inx...>) {
+			return Predicate<ChainOrder, Policy, Captures..., Capture_type>(
+				std::get<Inx>(std::move(captures_))..., std::move(capture));
+		}
+
+		template<std::size_t Inx>
+		using capture_type = std::tuple_element_t<Inx, std::tuple<Captures...>>;
+
+		// Type of the operand "Inx" resolved by the arguments "Args", a tuple
+		template<typename Args, std::size_t Inx>
+		using operand_type = std::decay_t<decltype(resolve(
+			std::declval<const typename capture_type<Inx>::r_type&>(), std::declval<const Args&>()))>;
+
+		template<typename Args, std::size_t... Inx>
+		static constexpr bool transitive(std::index_sequence<Inx...>) {
+			return (is_transitive<operand_type<Args, Inx>>::value && ...);
+		}
+
+		template<typename Args>
+		static constexpr bool transitive() { return transitive<Args>(std::index_sequence_for<Captures...>{}); }
+
+		template<typename Args, std::size_t... LIndex>
+		constexpr bool eval_adjacent(const Args& args, std::index_sequence<LIndex...>) const {
+			return (compare(resolve(std::get<LIndex>(captures_).rhs_, args),
+				resolve(std::get<LIndex + 1>(captures_).rhs_, args),
+				typename capture_type<LIndex + 1>::oper_type{}) && ...);
+		}
+
+		// A pair is compared strictly if any link between them is strict
+		template<std::size_t LIndex, std::size_t... Inx>
+		static constexpr bool strict_between(std::index_sequence<Inx...>) {
+			return ((std::is_same<typename capture_type<LIndex + 1 + Inx>::oper_type, Operation::LowerThan>::value ||
+				std::is_same<typename capture_type<LIndex + 1 + Inx>::oper_type, Operation::GreaterThan>::value) || ...);
+		}
+
+		using strict_oper = std::conditional_t<descending, Operation::GreaterThan, Operation::LowerThan>;
+		using non_strict_oper = std::conditional_t<descending, Operation::GreaterThanEqual, Operation::LowerThanEqual>;
+
+		template<std::size_t LIndex, std::size_t RIndex, typename Args>
+		constexpr bool compare_pair(const Args& args) const {
+			using oper_type = std::conditional_t<strict_between<LIndex>(std::make_index_sequence<RIndex - LIndex>{}),
+				strict_oper, non_strict_oper>;
+			return compare(resolve(std::get<LIndex>(captures_).rhs_, args),
+				resolve(std::get<RIndex>(captures_).rhs_, args), oper_type{});
+		}
+
+		template<std::size_t Dist, typename Args, std::size_t... LIndex>
+		constexpr bool eval_for_dist(const Args& args, std::index_sequence<LIndex...>) const {
+			return (compare_pair<LIndex, LIndex + Dist>(args) && ...);
+		}
+
+		template<typename Args, std::size_t... Dist>
+		constexpr bool eval_all_pairs(const Args& args, std::index_sequence<Dist...>) const {
+			return (eval_for_dist<Dist + 1>(args, std::make_index_sequence<size() - Dist - 1>{}) && ...);
+		}
+
+		template<typename Args>
+		constexpr bool evaluate(const Args& args, Strategy::Adjacent) const {
+			return eval_adjacent(args, std::make_index_sequence<size() - 1>{});
+		}
+
+		template<typename Args, std::size_t... LIndex>
+		constexpr bool eval_branchless(const Args& args, std::index_sequence<LIndex...>) const {
+			return (true & ... & compare(resolve(std::get<LIndex>(captures_).rhs_, args),
+				resolve(std::get<LIndex + 1>(captures_).rhs_, args),
+				typename capture_type<LIndex + 1>::oper_type{}));
+		}
+
+		template<typename Args>
+		constexpr bool evaluate(const Args& args, Strategy::AllPairs) const {
+			return eval_all_pairs(args, std::make_index_sequence<size() - 1>{});
+		}
+
+		template<typename Args>
+		constexpr bool evaluate(const Args& args, Strategy::Branchless) const {
+			return eval_branchless(args, std::make_index_sequence<size() - 1>{});
+		}
+
+		template<typename... Args>
+		constexpr bool operator()(const Args&... args) const {
+			static_assert(sizeof...(Args) == arity(),
+				"Predicate requires one argument for each placeholder");
+			const auto values = std::forward_as_tuple(args...);
+			using args_type = decltype(values);
+			return evaluate(values, strategy_for<Policy, transitive<args_type>()>{});
+		}
+	};
+
+	// A chain can also start with a placeholder, e.g. "cmp::arg<0> <= cmp::arg<1>"
+	template<std::size_t N, typename RType>
+	constexpr auto operator <(Arg<N> lhs, RType&& rhs) {
+		return Predicate<Order::Ascending, Evaluation::ShortCircuit, Capture<Arg<N>, Operation::ChainBegin>>(
+			make_capture(lhs, Operation::ChainBegin{})) < std::forward<RType>(rhs);
+	}
+
+	template<std::size_t N, typename RType>
+	constexpr auto operator <=(Arg<N> lhs, RType&& rhs) {
+		return Predicate<Order::Ascending, Evaluation::ShortCircuit, Capture<Arg<N>, Operation::ChainBegin>>(
+			make_capture(lhs, Operation::ChainBegin{})) <= std::forward<RType>(rhs);
+	}
+
+	template<std::size_t N, typename RType>
+	constexpr auto operator >(Arg<N> lhs, RType&& rhs) {
+		return Predicate<Order::Descending, Evaluation::ShortCircuit, Capture<Arg<N>, Operation::ChainBegin>>(
+			make_capture(lhs, Operation::ChainBegin{})) > std::forward<RType>(rhs);
+	}
+
+	template<std::size_t N, typename RType>
+	constexpr auto operator >=(Arg<N> lhs, RType&& rhs) {
+		return Predicate<Order::Descending, Evaluation::ShortCircuit, Capture<Arg<N>, Operation::ChainBegin>>(
+			make_capture(lhs, Operation::ChainBegin{})) >= std::forward<RType>(rhs);
+	}
+
+
+	/*
+	 * "Conductor" object preserves information before and transfers it to the following.
+	 * Operations should follow chain order.
+	 * Ascending to ascending or descending to descending.
+	 * Breaking the order will result in a compile time error.
+	 * Mixes comparison order is not allowed.
+	 * Internal state is constant after construction.
+	 */
+	template<typename ChainOrder, typename Policy, std::size_t OperCnt, typename... Previous>
+	class Conductor {
+	public:
+		Reserve_store<std::index_sequence_for<Previous...>, Previous...> previous_;
+
+		static constexpr bool transitive = (is_transitive<std::decay_t<typename Previous::r_type>>::value && ...);
+		static constexpr bool contradiction = contradicts<std::is_same<ChainOrder, Order::Descending>::value,
+			void, false, Previous...>::value;
+		using strategy = std::conditional_t<transitive && contradiction, Strategy::AlwaysFalse,
+			strategy_for<Policy, transitive>>;
+
+		constexpr Conductor(const Previous&... previous) : previous_(previous...) {}
+		constexpr Conductor(Previous&&... previous) : previous_(std::move(previous)...) {}
+
+#if defined(CMP_INSTRUMENT)
+		std::source_location site_{}; // Set by the initiator and passed along the chain
+#endif
+
+		/*
+		 * These operators are only allowed for an "Ascending" ordered comparison chain.
 		 * Otherwise will result in a compile time error.
 		 */
 		 //	template<typename RType>
@@ -292,14 +1353,84 @@ namespace cmp {
 		 //				"Ambiguously ordered comparison chain");
 		 //		return Conductor<RType, Order::Ascending>(rhs, result_ && (lhs_ < rhs));
 		 //	}
-		template<typename RType>
-		auto operator <(const RType& rhs) const {
-			using reserve_type = Reserve<RType, Operation::LowerThan>;
+		template<typename RType, typename = if_operand<RType>>
+		constexpr auto operator <(const RType& rhs) const & {
+			return Conductor(*this) < rhs;
+		}
+		template<typename RType, typename = if_operand<RType>>
+		constexpr auto operator <(const RType& rhs) && {
+			static_assert(std::is_same<ChainOrder, Order::Ascending>::value,
+				"Ambiguously ordered comparison chain");
+			return std::move(*this).append(Reserve<RType, Operation::LowerThan>(rhs));
+		}
+		template<typename RType, typename = if_operand<RType>>
+		constexpr auto operator <=(const RType& rhs) const & {
+			return Conductor(*this) <= rhs;
+		}
+		template<typename RType, typename = if_operand<RType>>
+		constexpr auto operator <=(const RType& rhs) && {
+			static_assert(std::is_same<ChainOrder, Order::Ascending>::value,
+				"Ambiguously ordered comparison chain");
+			return std::move(*this).append(Reserve<RType, Operation::LowerThanEqual>(rhs));
+		}
+
+		/*
+		 * The Reserves of a temporary Conductor are moved into the next one,
+		 * a named Conductor is copied first by the "const &" operators.
+		 */
+		template<typename Reserve_type>
+		constexpr auto append(Reserve_type&& reserve) && {
+			return std::move(*this).append(std::move(reserve), std::index_sequence_for<Previous...>{});
+		}
+
+		template<typename Reserve_type, std::size_t... Inx>
+		constexpr auto append(Reserve_type&& reserve, std::index_sequence<Inx...>) && {
+#if !defined(CMP_INSTRUMENT)
+			return Conductor<ChainOrder, Policy, OperCnt + 1, Previous..., Reserve_type>(take_at<Inx>(previous_)...,
+				std::move(reserve));
+#else
+			auto next = Conductor<ChainOrder, Policy, OperCnt + 1, Previous..., Reserve_type>(take_at<Inx>(previous_)...,
+				std::move(reserve));
+			next.site_ = site_;
+			return next;
+#endif
+		}
+
+		/*
+		 * A placeholder turns the chain into a "Predicate".
+		 * Operands preceding the placeholder are copied into the predicate.
+		 */
+		template<std::size_t N>
+		constexpr auto operator <(Arg<N> rhs) const {
+			static_assert(std::is_same<ChainOrder, Order::Ascending>::value,
+				"Ambiguously ordered comparison chain");
+			return to_predicate(std::index_sequence_for<Previous...>{}) < rhs;
+		}
+		template<std::size_t N>
+		constexpr auto operator <=(Arg<N> rhs) const {
 			static_assert(std::is_same<ChainOrder, Order::Ascending>::value,
 				"Ambiguously ordered comparison chain");
-			return Conductor<Order::Ascending, OperCnt + 1, Previous..., reserve_type>(
-				std::tuple_cat(previous_, std::make_tuple(reserve_type(rhs))));
+			return to_predicate(std::index_sequence_for<Previous...>{}) <= rhs;
+		}
+		template<std::size_t N>
+		constexpr auto operator >(Arg<N> rhs) const {
+			static_assert(std::is_same<ChainOrder, Order::Descending>::value,
+				"Ambiguously ordered comparison chain");
+			return to_predicate(std::index_sequence_for<Previous...>{}) > rhs;
+		}
+		template<std::size_t N>
+		constexpr auto operator >=(Arg<N> rhs) const {
+			static_assert(std::is_same<ChainOrder, Order::Descending>::value,
+				"Ambiguously ordered comparison chain");
+			return to_predicate(std::index_sequence_for<Previous...>{}) >= rhs;
+		}
+
+		template<std::size_t... Inx>
+		constexpr auto to_predicate(std::index_sequence<Inx...>) const {
+			return Predicate<ChainOrder, Policy, decltype(make_capture(reserve_at<Inx>(previous_)))...>(
+				make_capture(reserve_at<Inx>(previous_))...);
 		}
+
 		//	template<typename RType>
 		//	Conductor<RType, Order::Ascending, KnownType> operator <=(RType& rhs) const {
 		//		static_assert(std::is_same<ChainOrder, Order::Ascending>::value,
@@ -314,40 +1445,44 @@ namespace cmp {
 		//		return Conductor<RType, Order::Ascending, RType>(rhs, result_ && (lhs_ <= rhs), rhs);
 		//	}
 
-		//	/*
-		//	 * These operators are only allowed for an "Descending" ordered comparison chain.
-		//	 * Otherwise will result in a compile time error.
-		//	 */
-		//	template<typename RType>
-		//	Conductor<RType, Order::Descending, KnownType> operator >(RType& rhs) const {
-		//		static_assert(std::is_same<ChainOrder, Order::Descending>::value,
-		//				"Ambiguously ordered comparison chain");
-		//		return Conductor<RType, Order::Descending, KnownType>(rhs, result_ && (lhs_ > rhs), known_value_);
-		//	}
-		//	template<typename RType>
-		//	Conductor<RType, Order::Descending, RType> operator >(RType&& rhs) const {
-		//		static_assert(std::is_same<ChainOrder, Order::Descending>::value,
-		//				"Ambiguously ordered comparison chain");
-		//		assert(("Always false", !std::is_same<KnownType, Unknown_t>::value && (known_value_ <= rhs)));
-		//		return Conductor<RType, Order::Descending, RType>(rhs, result_ && (lhs_ > rhs), rhs);
-		//	}
-		//	template<typename RType>
-		//	Conductor<RType, Order::Descending, KnownType> operator>=(RType& rhs) const {
-		//		static_assert(std::is_same<ChainOrder, Order::Descending>::value,
-		//				"Ambiguously ordered comparison chain");
-		//		return Conductor<RType, Order::Descending, KnownType>(rhs, result_ && (lhs_>= rhs), known_value_);
-		//	}
-		//	template<typename RType>
-		//	Conductor<RType, Order::Descending, RType> operator>=(RType&& rhs) const {
-		//		static_assert(std::is_same<ChainOrder, Order::Descending>::value,
-		//				"Ambiguously ordered comparison chain");
-		//		assert(("Always false", !std::is_same<KnownType, Unknown_t>::value && (known_value_ < rhs)));
-		//		return Conductor<RType, Order::Descending, RType>(rhs, result_ && (lhs_>= rhs), rhs);
-		//	}
+		/*
+		 * These operators are only allowed for an "Descending" ordered comparison chain.
+		 * Otherwise will result in a compile time error.
+		 */
+		template<typename RType, typename = if_operand<RType>>
+		constexpr auto operator >(const RType& rhs) const & {
+			return Conductor(*this) > rhs;
+		}
+		template<typename RType, typename = if_operand<RType>>
+		constexpr auto operator >(const RType& rhs) && {
+			static_assert(std::is_same<ChainOrder, Order::Descending>::value,
+				"Ambiguously ordered comparison chain");
+			return std::move(*this).append(Reserve<RType, Operation::GreaterThan>(rhs));
+		}
+		template<typename RType, typename = if_operand<RType>>
+		constexpr auto operator >=(const RType& rhs) const & {
+			return Conductor(*this) >= rhs;
+		}
+		template<typename RType, typename = if_operand<RType>>
+		constexpr auto operator >=(const RType& rhs) && {
+			static_assert(std::is_same<ChainOrder, Order::Descending>::value,
+				"Ambiguously ordered comparison chain");
+			return std::move(*this).append(Reserve<RType, Operation::GreaterThanEqual>(rhs));
+		}
 
+#if defined(CMP_INSTRUMENT)
+		bool evaluate_probed() const {
+			instrument::Probe probe(site_);
+			return probe.finish(Implement<Previous...>::comparison(previous_, probe, strategy{}));
+		}
+#endif
 
-		inline operator bool() const {
-			return Implement<0, 1, sizeof...(Previous)-1, Previous...>::comparison(previous_);
+		constexpr operator bool() const {
+#if defined(CMP_INSTRUMENT)
+			if (!std::is_constant_evaluated())
+				return evaluate_probed();
+#endif
+			return Implement<Previous...>::comparison(previous_, strategy{});
 		}
 	};
 
@@ -360,6 +1495,7 @@ namespace cmp {
 	 *	Starting with ">" forces descending order.
 	 *	For descending, only ">" and ">=" is allowed.
 	 */
+	template<typename Policy = Evaluation::ShortCircuit>
 	class Initiator {
 
 	public:
@@ -367,28 +1503,2597 @@ namespace cmp {
 		//	Conductor<RType, Order::Ascending> operator <<(RType& rhs) const {
 		//		return Conductor<RType, Order::Ascending>(rhs, true);
 		//	}
+#if !defined(CMP_INSTRUMENT)
 		template<typename RType>
-		auto operator <<(const RType& rhs) const {
+		constexpr auto operator <<(const RType& rhs) const {
 			using reserve_type = Reserve<RType, Operation::ChainBegin>;
-			return Conductor<Order::Ascending, 1, reserve_type>(
-				std::make_tuple(reserve_type(rhs)));
+			return Conductor<Order::Ascending, Policy, 1, reserve_type>(reserve_type(rhs));
 		}
-		//	template<typename RType>
-		//	Conductor<RType, Order::Descending, Unknown_t> operator >>(RType& rhs) const {
-		//		return Conductor<RType, Order::Descending, Unknown_t>(rhs, true, Unknown_t {});
-		//	}
-		//	template<typename RType>
-		//	Conductor<RType, Order::Descending, RType> operator >>(RType&& rhs) const {
-		//		return Conductor<RType, Order::Descending, RType>(rhs, true, rhs);
-		//	}
+#endif
+		template<std::size_t N>
+		constexpr auto operator <<(Arg<N> rhs) const {
+			return Predicate<Order::Ascending, Policy, Capture<Arg<N>, Operation::ChainBegin>>(
+				make_capture(rhs, Operation::ChainBegin{}));
+		}
+		template<std::size_t N>
+		constexpr auto operator >>(Arg<N> rhs) const {
+			return Predicate<Order::Descending, Policy, Capture<Arg<N>, Operation::ChainBegin>>(
+				make_capture(rhs, Operation::ChainBegin{}));
+		}
+#if !defined(CMP_INSTRUMENT)
+		template<typename RType>
+		constexpr auto operator >>(const RType& rhs) const {
+			using reserve_type = Reserve<RType, Operation::ChainBegin>;
+			return Conductor<Order::Descending, Policy, 1, reserve_type>(reserve_type(rhs));
+		}
+#else
+		// The initiator converts to a "Call_site" at the place of the chain
+		template<typename RType>
+		friend constexpr auto operator <<(instrument::Call_site<Initiator> root, const RType& rhs) {
+			using reserve_type = Reserve<RType, Operation::ChainBegin>;
+			auto conductor = Conductor<Order::Ascending, Policy, 1, reserve_type>(reserve_type(rhs));
+			conductor.site_ = root.site;
+			return conductor;
+		}
+		template<typename RType>
+		friend constexpr auto operator >>(instrument::Call_site<Initiator> root, const RType& rhs) {
+			using reserve_type = Reserve<RType, Operation::ChainBegin>;
+			auto conductor = Conductor<Order::Descending, Policy, 1, reserve_type>(reserve_type(rhs));
+			conductor.site_ = root.site;
+			return conductor;
+		}
+#endif
 	};
 
 	/*
 	 * "chain" is the default "Initiator" instance. It doesn't have internal state.
 	 * It is defined for ease and comfort. Usage of "Initiator {}" in place of "chain"
-	 * is also possible.
+	 * is also possible. "branchless_chain" evaluates by "Evaluation::Branchless".
+	 */
+	constexpr Initiator<> chain{};
+	constexpr Initiator<Evaluation::Branchless> branchless_chain{};
+
+	/*
+	 * Bounds of a single placeholder predicate "lo < _ <= hi" over the type T.
+	 * LowerOp and UpperOp are the operation tags of the two links.
+	 */
+	template<typename T, typename LowerOp, typename UpperOp>
+	struct Bounds {
+		typedef LowerOp lower_type;
+		typedef UpperOp upper_type;
+		T lo;
+		T hi;
+	};
+
+	// A bound is converted to T only if the comparison is done in T anyway
+	template<typename T, typename BType>
+	struct is_exact_bound : std::integral_constant<bool,
+		std::is_arithmetic<T>::value && std::is_arithmetic<BType>::value &&
+		std::is_same<std::common_type_t<T, BType>, T>::value> {};
+
+	template<typename T>
+	constexpr T lowest_bound() {
+		return std::numeric_limits<T>::has_infinity ?
+			-std::numeric_limits<T>::infinity() : std::numeric_limits<T>::lowest();
+	}
+
+	template<typename T>
+	constexpr T highest_bound() {
+		return std::numeric_limits<T>::has_infinity ?
+			std::numeric_limits<T>::infinity() : std::numeric_limits<T>::max();
+	}
+
+	/*
+	 * "Range_traits" recognizes the predicates "lo < _ < hi", "_ < hi" and "lo < _"
+	 * (any of "<" may be "<="). A missing bound is replaced by the inclusive limit
+	 * of the type, which gives the same result for every value including NaN.
+	 */
+	template<typename T, typename Pred>
+	struct Range_traits : std::false_type {};
+
+	template<typename T, typename LType, typename LowerOp, typename UpperOp, typename HType, typename Policy>
+	struct Range_traits<T, Predicate<Order::Ascending, Policy, Capture<LType, Operation::ChainBegin>,
+		Capture<Arg<0>, LowerOp>, Capture<HType, UpperOp>>> :
+		std::integral_constant<bool, is_exact_bound<T, LType>::value && is_exact_bound<T, HType>::value> {
+		using bounds_type = Bounds<T, LowerOp, UpperOp>;
+
+		template<typename Pred>
+		static constexpr bounds_type bounds(const Pred& pred) {
+			return{ T(std::get<0>(pred.captures_).rhs_), T(std::get<2>(pred.captures_).rhs_) };
+		}
+	};
+
+	template<typename T, typename UpperOp, typename HType, typename Policy>
+	struct Range_traits<T, Predicate<Order::Ascending, Policy, Capture<Arg<0>, Operation::ChainBegin>,
+		Capture<HType, UpperOp>>> :
+		std::integral_constant<bool, is_exact_bound<T, HType>::value> {
+		using bounds_type = Bounds<T, Operation::LowerThanEqual, UpperOp>;
+
+		template<typename Pred>
+		static constexpr bounds_type bounds(const Pred& pred) {
+			return{ lowest_bound<T>(), T(std::get<1>(pred.captures_).rhs_) };
+		}
+	};
+
+	template<typename T, typename LType, typename LowerOp, typename Policy>
+	struct Range_traits<T, Predicate<Order::Ascending, Policy, Capture<LType, Operation::ChainBegin>,
+		Capture<Arg<0>, LowerOp>>> :
+		std::integral_constant<bool, is_exact_bound<T, LType>::value> {
+		using bounds_type = Bounds<T, LowerOp, Operation::LowerThanEqual>;
+
+		template<typename Pred>
+		static constexpr bounds_type bounds(const Pred& pred) {
+			return{ T(std::get<0>(pred.captures_).rhs_), highest_bound<T>() };
+		}
+	};
+
+	/*
+	 * "String_range" is the interval of a single placeholder predicate over strings,
+	 * e.g. auto in_range = cmp::string_range(cmp::chain << "abb" <= cmp::_ < "abe").
+	 * Every string between the bounds starts with their shared prefix ("ab"), so a
+	 * value is checked by a "memcmp" of the prefix and the byte following it.
+	 * Only a value having the same byte as a bound there ('b' or 'e') is compared
+	 * further. The bounds are copied once, values are read as "std::string_view".
 	 */
-	Initiator chain{};
+	template<typename LowerOp, typename UpperOp>
+	class String_range {
+	public:
+		String_range(std::optional<std::string_view> lo, std::optional<std::string_view> hi) :
+			lo_(lo.value_or(std::string_view())), hi_(hi.value_or(std::string_view())),
+			has_lo_(bool(lo)), has_hi_(bool(hi)) {
+			if (has_lo_ && has_hi_)
+				prefix_ = std::size_t(std::mismatch(lo_.begin(), lo_.begin() + std::min(lo_.size(), hi_.size()),
+					hi_.begin()).first - lo_.begin());
+			lower_byte_ = has_lo_ ? byte_at(lo_, prefix_) : -1;
+			upper_byte_ = has_hi_ ? byte_at(hi_, prefix_) : 257;
+		}
+
+		template<typename VType>
+		bool operator()(const VType& value) const {
+			const std::string_view x(value);
+			if (x.size() < prefix_ || (prefix_ && std::memcmp(x.data(), lo_.data(), prefix_) != 0))
+				return false;
+			const int byte = byte_at(x, prefix_);
+			if (byte != lower_byte_ && byte != upper_byte_)
+				return (lower_byte_ < byte) & (byte < upper_byte_);
+			// The same byte as a bound, the rest is compared only with that bound
+			const std::string_view rest = x.substr(prefix_);
+			return (byte == lower_byte_ ? compare(std::string_view(lo_).substr(prefix_), rest, LowerOp{}) : lower_byte_ < byte) &&
+				(byte == upper_byte_ ? compare(rest, std::string_view(hi_).substr(prefix_), UpperOp{}) : byte < upper_byte_);
+		}
+
+	private:
+		// The byte plus one, zero past the end
+		static int byte_at(std::string_view text, std::size_t inx) {
+			return inx < text.size() ? int(static_cast<unsigned char>(text[inx])) + 1 : 0;
+		}
+
+		std::string lo_;
+		std::string hi_;
+		bool has_lo_;
+		bool has_hi_;
+		std::size_t prefix_ = 0;
+		int lower_byte_; // -1 without a lower bound
+		int upper_byte_; // 257 without an upper bound
+	};
+
+	template<typename T>
+	struct is_string_bound : std::integral_constant<bool,
+		std::is_convertible<const T&, std::string_view>::value && !std::is_arithmetic<T>::value> {};
+
+	// "String_range_traits" recognizes the shapes of "Range_traits" with string bounds
+	template<typename Pred>
+	struct String_range_traits : std::false_type {};
+
+	template<typename LType, typename LowerOp, typename UpperOp, typename HType, typename Policy>
+	struct String_range_traits<Predicate<Order::Ascending, Policy, Capture<LType, Operation::ChainBegin>,
+		Capture<Arg<0>, LowerOp>, Capture<HType, UpperOp>>> :
+		std::integral_constant<bool, is_string_bound<LType>::value && is_string_bound<HType>::value> {
+		using range_type = String_range<LowerOp, UpperOp>;
+
+		template<typename Pred>
+		static range_type range(const Pred& pred) {
+			return range_type(std::string_view(std::get<0>(pred.captures_).rhs_),
+				std::string_view(std::get<2>(pred.captures_).rhs_));
+		}
+	};
+
+	template<typename UpperOp, typename HType, typename Policy>
+	struct String_range_traits<Predicate<Order::Ascending, Policy, Capture<Arg<0>, Operation::ChainBegin>,
+		Capture<HType, UpperOp>>> :
+		std::integral_constant<bool, is_string_bound<HType>::value> {
+		using range_type = String_range<Operation::LowerThanEqual, UpperOp>;
+
+		template<typename Pred>
+		static range_type range(const Pred& pred) {
+			return range_type(std::nullopt, std::string_view(std::get<1>(pred.captures_).rhs_));
+		}
+	};
+
+	template<typename LType, typename LowerOp, typename Policy>
+	struct String_range_traits<Predicate<Order::Ascending, Policy, Capture<LType, Operation::ChainBegin>,
+		Capture<Arg<0>, LowerOp>>> :
+		std::integral_constant<bool, is_string_bound<LType>::value> {
+		using range_type = String_range<LowerOp, Operation::LowerThanEqual>;
+
+		template<typename Pred>
+		static range_type range(const Pred& pred) {
+			return range_type(std::string_view(std::get<0>(pred.captures_).rhs_), std::nullopt);
+		}
+	};
+
+	// e.g. auto in_range = cmp::string_range(cmp::chain << lo <= cmp::_ < hi);
+	template<typename Pred>
+	auto string_range(const Pred& pred) {
+		static_assert(String_range_traits<Pred>::value, "cmp::string_range requires string bounds");
+		return String_range_traits<Pred>::range(pred);
+	}
+
+	inline unsigned popcount64(std::uint64_t bits) {
+#if defined(__GNUC__)
+		return unsigned(__builtin_popcountll(bits));
+#else
+		bits = bits - ((bits >> 1) & 0x5555555555555555ull);
+		bits = (bits & 0x3333333333333333ull) + ((bits >> 2) & 0x3333333333333333ull);
+		bits = (bits + (bits >> 4)) & 0x0f0f0f0f0f0f0f0full;
+		return unsigned((bits * 0x0101010101010101ull) >> 56);
+#endif
+	}
+
+	inline unsigned ctz64(std::uint64_t bits) {
+#if defined(__GNUC__)
+		return unsigned(__builtin_ctzll(bits));
+#else
+		unsigned inx = 0;
+		for (; !(bits & 1); bits >>= 1) ++inx;
+		return inx;
+#endif
+	}
+
+	// Index of the highest set bit, "bits" should not be zero
+	inline unsigned log2_64(std::uint64_t bits) {
+#if defined(__GNUC__)
+		return 63u - unsigned(__builtin_clzll(bits));
+#else
+		unsigned inx = 0;
+		while (bits >>= 1) ++inx;
+		return inx;
+#endif
+	}
+
+	/*
+	 * Selection kernels. Each kernel evaluates "blocks" blocks of 64 elements
+	 * and writes one mask word per block, bit "i" is set for the element "i".
+	 */
+	template<typename T>
+	using Mask_kernel = void(*)(const T* data, std::size_t blocks, std::uint64_t* masks, T lo, T hi);
+
+	namespace simd {
+
+		template<typename T, typename LowerOp, typename UpperOp>
+		void mask_scalar(const T* data, std::size_t blocks, std::uint64_t* masks, T lo, T hi) {
+			for (std::size_t block = 0; block < blocks; ++block, data += 64) {
+				std::uint64_t bits = 0;
+				for (std::size_t inx = 0; inx < 64; ++inx) {
+					bits |= std::uint64_t(compare(lo, data[inx], LowerOp{}) &
+						compare(data[inx], hi, UpperOp{})) << inx;
+				}
+				masks[block] = bits;
+			}
+		}
+
+#if defined(CMP_SIMD_X86)
+
+		/*
+		 * Lanes of an instruction set for the element type T.
+		 * "less" is the lane compare of the strict or non-strict link,
+		 * "bits" combines the lower and upper compares into a bit mask.
+		 */
+		template<typename T> struct Sse2_lanes { static constexpr bool enabled = false; };
+		template<typename T> struct Avx2_lanes { static constexpr bool enabled = false; };
+		template<typename T> struct Avx512_lanes { static constexpr bool enabled = false; };
+
+		template<> struct Sse2_lanes<float> {
+			static constexpr bool enabled = true;
+			static constexpr std::size_t width = 4;
+			using vec = __m128;
+			__attribute__((target("sse2"))) static vec splat(float v) { return _mm_set1_ps(v); }
+			__attribute__((target("sse2"))) static vec load(const float* p) { return _mm_loadu_ps(p); }
+			__attribute__((target("sse2"))) static vec less(vec a, vec b, Operation::LowerThan) { return _mm_cmplt_ps(a, b); }
+			__attribute__((target("sse2"))) static vec less(vec a, vec b, Operation::LowerThanEqual) { return _mm_cmple_ps(a, b); }
+			__attribute__((target("sse2"))) static unsigned bits(vec a, vec b) { return unsigned(_mm_movemask_ps(_mm_and_ps(a, b))); }
+		};
+
+		template<> struct Sse2_lanes<double> {
+			static constexpr bool enabled = true;
+			static constexpr std::size_t width = 2;
+			using vec = __m128d;
+			__attribute__((target("sse2"))) static vec splat(double v) { return _mm_set1_pd(v); }
+			__attribute__((target("sse2"))) static vec load(const double* p) { return _mm_loadu_pd(p); }
+			__attribute__((target("sse2"))) static vec less(vec a, vec b, Operation::LowerThan) { return _mm_cmplt_pd(a, b); }
+			__attribute__((target("sse2"))) static vec less(vec a, vec b, Operation::LowerThanEqual) { return _mm_cmple_pd(a, b); }
+			__attribute__((target("sse2"))) static unsigned bits(vec a, vec b) { return unsigned(_mm_movemask_pd(_mm_and_pd(a, b))); }
+		};
+
+		template<> struct Sse2_lanes<std::int32_t> {
+			static constexpr bool enabled = true;
+			static constexpr std::size_t width = 4;
+			using vec = __m128i;
+			__attribute__((target("sse2"))) static vec splat(std::int32_t v) { return _mm_set1_epi32(v); }
+			__attribute__((target("sse2"))) static vec load(const std::int32_t* p) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)); }
+			__attribute__((target("sse2"))) static vec less(vec a, vec b, Operation::LowerThan) { return _mm_cmpgt_epi32(b, a); }
+			__attribute__((target("sse2"))) static vec less(vec a, vec b, Operation::LowerThanEqual) { return _mm_xor_si128(_mm_cmpgt_epi32(a, b), _mm_set1_epi32(-1)); }
+			__attribute__((target("sse2"))) static unsigned bits(vec a, vec b) { return unsigned(_mm_movemask_ps(_mm_castsi128_ps(_mm_and_si128(a, b)))); }
+		};
+
+		template<> struct Avx2_lanes<float> {
+			static constexpr bool enabled = true;
+			static constexpr std::size_t width = 8;
+			using vec = __m256;
+			__attribute__((target("avx2"))) static vec splat(float v) { return _mm256_set1_ps(v); }
+			__attribute__((target("avx2"))) static vec load(const float* p) { return _mm256_loadu_ps(p); }
+			__attribute__((target("avx2"))) static vec less(vec a, vec b, Operation::LowerThan) { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+			__attribute__((target("avx2"))) static vec less(vec a, vec b, Operation::LowerThanEqual) { return _mm256_cmp_ps(a, b, _CMP_LE_OQ); }
+			__attribute__((target("avx2"))) static unsigned bits(vec a, vec b) { return unsigned(_mm256_movemask_ps(_mm256_and_ps(a, b))); }
+		};
+
+		template<> struct Avx2_lanes<double> {
+			static constexpr bool enabled = true;
+			static constexpr std::size_t width = 4;
+			using vec = __m256d;
+			__attribute__((target("avx2"))) static vec splat(double v) { return _mm256_set1_pd(v); }
+			__attribute__((target("avx2"))) static vec load(const double* p) { return _mm256_loadu_pd(p); }
+			__attribute__((target("avx2"))) static vec less(vec a, vec b, Operation::LowerThan) { return _mm256_cmp_pd(a, b, _CMP_LT_OQ); }
+			__attribute__((target("avx2"))) static vec less(vec a, vec b, Operation::LowerThanEqual) { return _mm256_cmp_pd(a, b, _CMP_LE_OQ); }
+			__attribute__((target("avx2"))) static unsigned bits(vec a, vec b) { return unsigned(_mm256_movemask_pd(_mm256_and_pd(a, b))); }
+		};
+
+		template<> struct Avx2_lanes<std::int32_t> {
+			static constexpr bool enabled = true;
+			static constexpr std::size_t width = 8;
+			using vec = __m256i;
+			__attribute__((target("avx2"))) static vec splat(std::int32_t v) { return _mm256_set1_epi32(v); }
+			__attribute__((target("avx2"))) static vec load(const std::int32_t* p) { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)); }
+			__attribute__((target("avx2"))) static vec less(vec a, vec b, Operation::LowerThan) { return _mm256_cmpgt_epi32(b, a); }
+			__attribute__((target("avx2"))) static vec less(vec a, vec b, Operation::LowerThanEqual) { return _mm256_xor_si256(_mm256_cmpgt_epi32(a, b), _mm256_set1_epi32(-1)); }
+			__attribute__((target("avx2"))) static unsigned bits(vec a, vec b) { return unsigned(_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_and_si256(a, b)))); }
+		};
+
+		template<> struct Avx2_lanes<std::int64_t> {
+			static constexpr bool enabled = true;
+			static constexpr std::size_t width = 4;
+			using vec = __m256i;
+			__attribute__((target("avx2"))) static vec splat(std::int64_t v) { return _mm256_set1_epi64x(v); }
+			__attribute__((target("avx2"))) static vec load(const std::int64_t* p) { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)); }
+			__attribute__((target("avx2"))) static vec less(vec a, vec b, Operation::LowerThan) { return _mm256_cmpgt_epi64(b, a); }
+			__attribute__((target("avx2"))) static vec less(vec a, vec b, Operation::LowerThanEqual) { return _mm256_xor_si256(_mm256_cmpgt_epi64(a, b), _mm256_set1_epi64x(-1)); }
+			__attribute__((target("avx2"))) static unsigned bits(vec a, vec b) { return unsigned(_mm256_movemask_pd(_mm256_castsi256_pd(_mm256_and_si256(a, b)))); }
+		};
+
+		template<> struct Avx512_lanes<float> {
+			static constexpr bool enabled = true;
+			static constexpr std::size_t width = 16;
+			using vec = __m512;
+			__attribute__((target("avx512f"))) static vec splat(float v) { return _mm512_set1_ps(v); }
+			__attribute__((target("avx512f"))) static vec load(const float* p) { return _mm512_loadu_ps(p); }
+			__attribute__((target("avx512f"))) static __mmask16 less(vec a, vec b, Operation::LowerThan) { return _mm512_cmp_ps_mask(a, b, _CMP_LT_OQ); }
+			__attribute__((target("avx512f"))) static __mmask16 less(vec a, vec b, Operation::LowerThanEqual) { return _mm512_cmp_ps_mask(a, b, _CMP_LE_OQ); }
+			__attribute__((target("avx512f"))) static unsigned bits(__mmask16 a, __mmask16 b) { return unsigned(a & b); }
+		};
+
+		template<> struct Avx512_lanes<double> {
+			static constexpr bool enabled = true;
+			static constexpr std::size_t width = 8;
+			using vec = __m512d;
+			__attribute__((target("avx512f"))) static vec splat(double v) { return _mm512_set1_pd(v); }
+			__attribute__((target("avx512f"))) static vec load(const double* p) { return _mm512_loadu_pd(p); }
+			__attribute__((target("avx512f"))) static __mmask8 less(vec a, vec b, Operation::LowerThan) { return _mm512_cmp_pd_mask(a, b, _CMP_LT_OQ); }
+			__attribute__((target("avx512f"))) static __mmask8 less(vec a, vec b, Operation::LowerThanEqual) { return _mm512_cmp_pd_mask(a, b, _CMP_LE_OQ); }
+			__attribute__((target("avx512f"))) static unsigned bits(__mmask8 a, __mmask8 b) { return unsigned(a & b); }
+		};
+
+		template<> struct Avx512_lanes<std::int32_t> {
+			static constexpr bool enabled = true;
+			static constexpr std::size_t width = 16;
+			using vec = __m512i;
+			__attribute__((target("avx512f"))) static vec splat(std::int32_t v) { return _mm512_set1_epi32(v); }
+			__attribute__((target("avx512f"))) static vec load(const std::int32_t* p) { return _mm512_loadu_si512(p); }
+			__attribute__((target("avx512f"))) static __mmask16 less(vec a, vec b, Operation::LowerThan) { return _mm512_cmplt_epi32_mask(a, b); }
+			__attribute__((target("avx512f"))) static __mmask16 less(vec a, vec b, Operation::LowerThanEqual) { return _mm512_cmple_epi32_mask(a, b); }
+			__attribute__((target("avx512f"))) static unsigned bits(__mmask16 a, __mmask16 b) { return unsigned(a & b); }
+		};
+
+		template<> struct Avx512_lanes<std::uint32_t> {
+			static constexpr bool enabled = true;
+			static constexpr std::size_t width = 16;
+			using vec = __m512i;
+			__attribute__((target("avx512f"))) static vec splat(std::uint32_t v) { return _mm512_set1_epi32(int(v)); }
+			__attribute__((target("avx512f"))) static vec load(const std::uint32_t* p) { return _mm512_loadu_si512(p); }
+			__attribute__((target("avx512f"))) static __mmask16 less(vec a, vec b, Operation::LowerThan) { return _mm512_cmplt_epu32_mask(a, b); }
+			__attribute__((target("avx512f"))) static __mmask16 less(vec a, vec b, Operation::LowerThanEqual) { return _mm512_cmple_epu32_mask(a, b); }
+			__attribute__((target("avx512f"))) static unsigned bits(__mmask16 a, __mmask16 b) { return unsigned(a & b); }
+		};
+
+		template<> struct Avx512_lanes<std::int64_t> {
+			static constexpr bool enabled = true;
+			static constexpr std::size_t width = 8;
+			using vec = __m512i;
+			__attribute__((target("avx512f"))) static vec splat(std::int64_t v) { return _mm512_set1_epi64(v); }
+			__attribute__((target("avx512f"))) static vec load(const std::int64_t* p) { return _mm512_loadu_si512(p); }
+			__attribute__((target("avx512f"))) static __mmask8 less(vec a, vec b, Operation::LowerThan) { return _mm512_cmplt_epi64_mask(a, b); }
+			__attribute__((target("avx512f"))) static __mmask8 less(vec a, vec b, Operation::LowerThanEqual) { return _mm512_cmple_epi64_mask(a, b); }
+			__attribute__((target("avx512f"))) static unsigned bits(__mmask8 a, __mmask8 b) { return unsigned(a & b); }
+		};
+
+		/*
+		 * The kernels are the same except the target attribute,
+		 * which is required for inlining the lane functions.
+		 */
+		template<typename Lanes, typename T, typename LowerOp, typename UpperOp>
+		__attribute__((target("sse2")))
+		void mask_sse2(const T* data, std::size_t blocks, std::uint64_t* masks, T lo, T hi) {
+			const auto vlo = Lanes::splat(lo);
+			const auto vhi = Lanes::splat(hi);
+			for (std::size_t block = 0; block < blocks; ++block, data += 64) {
+				std::uint64_t bits = 0;
+				for (std::size_t inx = 0; inx < 64; inx += Lanes::width) {
+					const auto x = Lanes::load(data + inx);
+					bits |= std::uint64_t(Lanes::bits(Lanes::less(vlo, x, LowerOp{}), Lanes::less(x, vhi, UpperOp{}))) << inx;
+				}
+				masks[block] = bits;
+			}
+		}
+
+		template<typename Lanes, typename T, typename LowerOp, typename UpperOp>
+		__attribute__((target("avx2")))
+		void mask_avx2(const T* data, std::size_t blocks, std::uint64_t* masks, T lo, T hi) {
+			const auto vlo = Lanes::splat(lo);
+			const auto vhi = Lanes::splat(hi);
+			for (std::size_t block = 0; block < blocks; ++block, data += 64) {
+				std::uint64_t bits = 0;
+				for (std::size_t inx = 0; inx < 64; inx += Lanes::width) {
+					const auto x = Lanes::load(data + inx);
+					bits |= std::uint64_t(Lanes::bits(Lanes::less(vlo, x, LowerOp{}), Lanes::less(x, vhi, UpperOp{}))) << inx;
+				}
+				masks[block] = bits;
+			}
+		}
+
+		template<typename Lanes, typename T, typename LowerOp, typename UpperOp>
+		__attribute__((target("avx512f")))
+		void mask_avx512(const T* data, std::size_t blocks, std::uint64_t* masks, T lo, T hi) {
+			const auto vlo = Lanes::splat(lo);
+			const auto vhi = Lanes::splat(hi);
+			for (std::size_t block = 0; block < blocks; ++block, data += 64) {
+				std::uint64_t bits = 0;
+				for (std::size_t inx = 0; inx < 64; inx += Lanes::width) {
+					const auto x = Lanes::load(data + inx);
+					bits |= std::uint64_t(Lanes::bits(Lanes::less(vlo, x, LowerOp{}), Lanes::less(x, vhi, UpperOp{}))) << inx;
+				}
+				masks[block] = bits;
+			}
+		}
+
+		template<typename T, typename LowerOp, typename UpperOp>
+		Mask_kernel<T> sse2_kernel(std::true_type) { return &mask_sse2<Sse2_lanes<T>, T, LowerOp, UpperOp>; }
+		template<typename T, typename LowerOp, typename UpperOp>
+		Mask_kernel<T> sse2_kernel(std::false_type) { return nullptr; }
+
+		template<typename T, typename LowerOp, typename UpperOp>
+		Mask_kernel<T> avx2_kernel(std::true_type) { return &mask_avx2<Avx2_lanes<T>, T, LowerOp, UpperOp>; }
+		template<typename T, typename LowerOp, typename UpperOp>
+		Mask_kernel<T> avx2_kernel(std::false_type) { return nullptr; }
+
+		template<typename T, typename LowerOp, typename UpperOp>
+		Mask_kernel<T> avx512_kernel(std::true_type) { return &mask_avx512<Avx512_lanes<T>, T, LowerOp, UpperOp>; }
+		template<typename T, typename LowerOp, typename UpperOp>
+		Mask_kernel<T> avx512_kernel(std::false_type) { return nullptr; }
+
+		// 0: none, 1: SSE2, 2: AVX2, 3: AVX-512, the lower of the processor and CMP_SIMD_LEVEL
+		inline int isa_level() {
+			static const int level = [] {
+				__builtin_cpu_init();
+				return std::min(int(CMP_SIMD_LEVEL), __builtin_cpu_supports("avx512f") ? 3 :
+					__builtin_cpu_supports("avx2") ? 2 :
+					__builtin_cpu_supports("sse2") ? 1 : 0);
+			}();
+			return level;
+		}
+#endif
+
+		// The best kernel supported by both the processor and the element type
+		template<typename T, typename LowerOp, typename UpperOp>
+		Mask_kernel<T> select_kernel() {
+			Mask_kernel<T> kernel = nullptr;
+#if defined(CMP_SIMD_X86)
+			const int level = isa_level();
+			if (level >= 3)
+				kernel = avx512_kernel<T, LowerOp, UpperOp>(std::integral_constant<bool, Avx512_lanes<T>::enabled>{});
+			if (!kernel && level >= 2)
+				kernel = avx2_kernel<T, LowerOp, UpperOp>(std::integral_constant<bool, Avx2_lanes<T>::enabled>{});
+			if (!kernel && level >= 1)
+				kernel = sse2_kernel<T, LowerOp, UpperOp>(std::integral_constant<bool, Sse2_lanes<T>::enabled>{});
+#endif
+			return kernel ? kernel : &mask_scalar<T, LowerOp, UpperOp>;
+		}
+
+		/*
+		 * Calls "sink(word, bits)" for each 64 element block of the array.
+		 * The bits of the last partial block beyond "n" are zero.
+		 */
+		template<typename T, typename Pred, typename Sink>
+		void scan(const Pred& pred, const T* data, std::size_t n, Sink&& sink, std::true_type) {
+			using traits = Range_traits<T, Pred>;
+			using bounds_type = typename traits::bounds_type;
+			using lower_type = typename bounds_type::lower_type;
+			using upper_type = typename bounds_type::upper_type;
+			static const Mask_kernel<T> kernel = select_kernel<T, lower_type, upper_type>();
+
+			const bounds_type bounds = traits::bounds(pred);
+			constexpr std::size_t chunk = 32;
+			std::uint64_t masks[chunk];
+			const std::size_t blocks = n / 64;
+			for (std::size_t block = 0; block < blocks; block += chunk) {
+				const std::size_t count = std::min(chunk, blocks - block);
+				kernel(data + block * 64, count, masks, bounds.lo, bounds.hi);
+				for (std::size_t inx = 0; inx < count; ++inx)
+					sink(block + inx, masks[inx]);
+			}
+			if (n % 64) {
+				std::uint64_t bits = 0;
+				for (std::size_t inx = blocks * 64; inx < n; ++inx) {
+					bits |= std::uint64_t(compare(bounds.lo, data[inx], lower_type{}) &
+						compare(data[inx], bounds.hi, upper_type{})) << (inx % 64);
+				}
+				sink(blocks, bits);
+			}
+		}
+
+		template<typename T, typename Pred, typename Sink>
+		void scan(const Pred& pred, const T* data, std::size_t n, Sink&& sink, std::false_type) {
+			for (std::size_t block = 0; block * 64 < n; ++block) {
+				const std::size_t end = std::min(n, block * 64 + 64);
+				std::uint64_t bits = 0;
+				for (std::size_t inx = block * 64; inx < end; ++inx)
+					bits |= std::uint64_t(bool(pred(data[inx]))) << (inx % 64);
+				sink(block, bits);
+			}
+		}
+
+		// A string range predicate over string elements is scanned by its "String_range"
+		template<typename T, typename Pred, typename Sink>
+		void scan(const Pred& pred, const T* data, std::size_t n, Sink&& sink) {
+			if constexpr (std::is_class<T>::value && is_string_bound<T>::value && String_range_traits<Pred>::value) {
+				scan(string_range(pred), data, n, std::forward<Sink>(sink), std::false_type{});
+			}
+			else {
+				scan(pred, data, n, std::forward<Sink>(sink),
+					std::integral_constant<bool, Range_traits<T, Pred>::value>{});
+			}
+		}
+
+	} /* namespace simd */
+
+	/*
+	 * Batch evaluation of a single placeholder predicate over a contiguous array.
+	 * Predicates of the form "lo < _ <= hi", "_ < hi" and "lo <= _" over int32,
+	 * int64, float and double elements are evaluated by SSE2, AVX2 or AVX-512
+	 * kernels chosen at runtime, over string elements by a "String_range".
+	 * Any other predicate is called element by element.
+	 * The results are the same as calling the predicate for each element.
+	 */
+
+	// Writes one bit per element into (n + 63) / 64 words of "mask"
+	template<typename Pred, typename T>
+	void select_mask(const Pred& pred, const T* data, std::size_t n, std::uint64_t* mask) {
+		simd::scan(pred, data, n, [mask](std::size_t word, std::uint64_t bits) { mask[word] = bits; });
+	}
+
+	// Writes the indices of the matching elements and returns their count
+	template<typename Pred, typename T>
+	std::size_t select_index(const Pred& pred, const T* data, std::size_t n, std::size_t* index) {
+		std::size_t count = 0;
+		simd::scan(pred, data, n, [index, &count](std::size_t word, std::uint64_t bits) {
+			for (; bits; bits &= bits - 1)
+				index[count++] = word * 64 + ctz64(bits);
+		});
+		return count;
+	}
+
+	template<typename Pred, typename T>
+	std::size_t select_count(const Pred& pred, const T* data, std::size_t n) {
+		std::size_t count = 0;
+		simd::scan(pred, data, n, [&count](std::size_t, std::uint64_t bits) { count += popcount64(bits); });
+		return count;
+	}
+
+	template<typename Pred, typename Container>
+	std::vector<std::uint64_t> select_mask(const Pred& pred, const Container& column) {
+		std::vector<std::uint64_t> mask((column.size() + 63) / 64);
+		select_mask(pred, column.data(), column.size(), mask.data());
+		return mask;
+	}
+
+	template<typename Pred, typename Container>
+	std::vector<std::size_t> select_index(const Pred& pred, const Container& column) {
+		std::vector<std::size_t> index(column.size());
+		index.resize(select_index(pred, column.data(), column.size(), index.data()));
+		return index;
+	}
+
+	template<typename Pred, typename Container>
+	std::size_t select_count(const Pred& pred, const Container& column) {
+		return select_count(pred, column.data(), column.size());
+	}
+
+	/*
+	 * Two bounds are exact in their common type unless a signed bound becomes unsigned,
+	 * e.g. "-5 < _ <= 10u", whose predicate compares "-5 < x" as int but "x <= 10u" as unsigned.
+	 */
+	template<typename LType, typename HType, typename T = std::common_type_t<LType, HType>>
+	struct is_exact_range : std::integral_constant<bool,
+		is_exact_bound<T, LType>::value && is_exact_bound<T, HType>::value &&
+		!(std::is_unsigned<T>::value && (std::is_signed<LType>::value || std::is_signed<HType>::value))> {};
+
+	// Value type of the bounds of a single placeholder predicate
+	template<typename Pred>
+	struct Bound_type {};
+
+	template<typename LType, typename LowerOp, typename UpperOp, typename HType, typename Policy>
+	struct Bound_type<Predicate<Order::Ascending, Policy, Capture<LType, Operation::ChainBegin>,
+		Capture<Arg<0>, LowerOp>, Capture<HType, UpperOp>>> {
+		static_assert(is_exact_range<LType, HType>::value, "Bounds of cmp::range are not exact in their common type");
+		using type = std::common_type_t<LType, HType>;
+	};
+
+	template<typename UpperOp, typename HType, typename Policy>
+	struct Bound_type<Predicate<Order::Ascending, Policy, Capture<Arg<0>, Operation::ChainBegin>,
+		Capture<HType, UpperOp>>> {
+		using type = HType;
+	};
+
+	template<typename LType, typename LowerOp, typename Policy>
+	struct Bound_type<Predicate<Order::Ascending, Policy, Capture<LType, Operation::ChainBegin>,
+		Capture<Arg<0>, LowerOp>>> {
+		using type = LType;
+	};
+
+	/*
+	 * "Range" is the interval of a single placeholder predicate, computed once.
+	 * Integer ranges are converted to inclusive bounds [lo, lo + width], so a value
+	 * is checked by a single unsigned subtract and compare, "(x - lo) <= width".
+	 * Values are of the bound type T; other types should use the predicate itself.
+	 */
+	template<typename T, typename LowerOp, typename UpperOp,
+		bool = std::is_integral<T>::value && !std::is_same<T, bool>::value>
+	class Range {
+		Bounds<T, LowerOp, UpperOp> bounds_;
+	public:
+		constexpr Range(const Bounds<T, LowerOp, UpperOp>& bounds) : bounds_(bounds) {}
+
+		constexpr bool empty() const {
+			return !(std::is_same<LowerOp, Operation::LowerThanEqual>::value &&
+				std::is_same<UpperOp, Operation::LowerThanEqual>::value ?
+				bounds_.lo <= bounds_.hi : bounds_.lo < bounds_.hi);
+		}
+
+		template<typename VType>
+		constexpr bool operator()(const VType& value) const {
+			static_assert(is_exact_bound<T, VType>::value, "Value is not comparable in the bound type");
+			return compare(bounds_.lo, value, LowerOp{}) && compare(value, bounds_.hi, UpperOp{});
+		}
+	};
+
+	template<typename T, typename LowerOp, typename UpperOp>
+	class Range<T, LowerOp, UpperOp, true> {
+		using unsigned_type = std::make_unsigned_t<T>;
+		T lo_;
+		unsigned_type width_;
+		bool empty_;
+	public:
+		constexpr Range(const Bounds<T, LowerOp, UpperOp>& bounds) : lo_(), width_(), empty_(false) {
+			T lo = bounds.lo;
+			T hi = bounds.hi;
+			if (std::is_same<LowerOp, Operation::LowerThan>::value) {
+				empty_ = empty_ || lo == std::numeric_limits<T>::max();
+				lo = empty_ ? lo : T(lo + 1);
+			}
+			if (std::is_same<UpperOp, Operation::LowerThan>::value) {
+				empty_ = empty_ || hi == std::numeric_limits<T>::lowest();
+				hi = empty_ ? hi : T(hi - 1);
+			}
+			empty_ = empty_ || hi < lo;
+			lo_ = lo;
+			width_ = empty_ ? unsigned_type(0) : unsigned_type(unsigned_type(hi) - unsigned_type(lo));
+		}
+
+		constexpr bool empty() const { return empty_; }
+
+		// "&" instead of "&&" leaves a single branch for the caller
+		template<typename VType>
+		constexpr bool operator()(const VType& value) const {
+			static_assert(is_exact_bound<T, VType>::value, "Value is not comparable in the bound type");
+			return !empty_ & (unsigned_type(unsigned_type(T(value)) - unsigned_type(lo_)) <= width_);
+		}
+	};
+
+	// e.g. auto in_range = cmp::range(cmp::chain << lo < cmp::_ <= hi);
+	template<typename Pred>
+	constexpr auto range(const Pred& pred) {
+		using value_type = typename Bound_type<Pred>::type;
+		using traits = Range_traits<value_type, Pred>;
+		static_assert(traits::value, "cmp::range requires arithmetic bounds");
+		using bounds_type = typename traits::bounds_type;
+		return Range<value_type, typename bounds_type::lower_type, typename bounds_type::upper_type>(traits::bounds(pred));
+	}
+
+	// Replaces "bound" by the smallest greater value, false if there is none
+	template<typename T>
+	bool next_value(T& bound) {
+		if constexpr (std::is_floating_point<T>::value) {
+			if (!(bound < std::numeric_limits<T>::infinity()))
+				return false;
+			bound = std::nextafter(bound, std::numeric_limits<T>::infinity());
+		}
+		else {
+			if (bound == std::numeric_limits<T>::max())
+				return false;
+			++bound;
+		}
+		return true;
+	}
+
+	// Number of the sorted "bounds" less than or equal to "value", by a branchless binary search
+	template<typename T>
+	std::size_t upper_rank(const T* bounds, std::size_t size, T value) {
+		if (!size)
+			return 0;
+		const T* base = bounds;
+		for (std::size_t len = size; len > 1; len -= len / 2)
+			base = base[len / 2] <= value ? base + len / 2 : base;
+		return std::size_t(base - bounds) + (*base <= value);
+	}
+
+	/*
+	 * Histogram kernels of "Buckets". "bounds" is padded up to "padded" elements
+	 * by its last element, so a rank is clamped to "size".
+	 */
+	template<typename T>
+	using Bucket_kernel = void(*)(const T* bounds, std::size_t size, std::size_t padded,
+		const T* data, std::size_t n, std::size_t* counts);
+
+	namespace simd {
+
+		template<typename T>
+		void bucket_scalar(const T* bounds, std::size_t size, std::size_t,
+			const T* data, std::size_t n, std::size_t* counts) {
+			for (std::size_t inx = 0; inx < n; ++inx)
+				++counts[upper_rank(bounds, size, data[inx])];
+		}
+
+#if defined(CMP_SIMD_X86)
+		// One compare of a lane of bounds against the splatted value, counted by popcount
+		template<typename Lanes, typename T>
+		__attribute__((target("sse2")))
+		void bucket_sse2(const T* bounds, std::size_t size, std::size_t padded,
+			const T* data, std::size_t n, std::size_t* counts) {
+			for (std::size_t inx = 0; inx < n; ++inx) {
+				const auto x = Lanes::splat(data[inx]);
+				std::size_t rank = 0;
+				for (std::size_t bnd = 0; bnd < padded; bnd += Lanes::width) {
+					const auto le = Lanes::less(Lanes::load(bounds + bnd), x, Operation::LowerThanEqual{});
+					rank += popcount64(Lanes::bits(le, le));
+				}
+				++counts[std::min(rank, size)];
+			}
+		}
+
+		template<typename Lanes, typename T>
+		__attribute__((target("avx2,popcnt")))
+		void bucket_avx2(const T* bounds, std::size_t size, std::size_t padded,
+			const T* data, std::size_t n, std::size_t* counts) {
+			for (std::size_t inx = 0; inx < n; ++inx) {
+				const auto x = Lanes::splat(data[inx]);
+				std::size_t rank = 0;
+				for (std::size_t bnd = 0; bnd < padded; bnd += Lanes::width) {
+					const auto le = Lanes::less(Lanes::load(bounds + bnd), x, Operation::LowerThanEqual{});
+					rank += popcount64(Lanes::bits(le, le));
+				}
+				++counts[std::min(rank, size)];
+			}
+		}
+
+		template<typename Lanes, typename T>
+		__attribute__((target("avx512f,popcnt")))
+		void bucket_avx512(const T* bounds, std::size_t size, std::size_t padded,
+			const T* data, std::size_t n, std::size_t* counts) {
+			for (std::size_t inx = 0; inx < n; ++inx) {
+				const auto x = Lanes::splat(data[inx]);
+				std::size_t rank = 0;
+				for (std::size_t bnd = 0; bnd < padded; bnd += Lanes::width) {
+					const auto le = Lanes::less(Lanes::load(bounds + bnd), x, Operation::LowerThanEqual{});
+					rank += popcount64(Lanes::bits(le, le));
+				}
+				++counts[std::min(rank, size)];
+			}
+		}
+
+		template<typename T>
+		Bucket_kernel<T> sse2_bucket(std::true_type) { return &bucket_sse2<Sse2_lanes<T>, T>; }
+		template<typename T>
+		Bucket_kernel<T> sse2_bucket(std::false_type) { return nullptr; }
+
+		template<typename T>
+		Bucket_kernel<T> avx2_bucket(std::true_type) { return &bucket_avx2<Avx2_lanes<T>, T>; }
+		template<typename T>
+		Bucket_kernel<T> avx2_bucket(std::false_type) { return nullptr; }
+
+		template<typename T>
+		Bucket_kernel<T> avx512_bucket(std::true_type) { return &bucket_avx512<Avx512_lanes<T>, T>; }
+		template<typename T>
+		Bucket_kernel<T> avx512_bucket(std::false_type) { return nullptr; }
+#endif
+
+		// The compare-and-popcount kernel of the processor, or null for the element type
+		template<typename T>
+		Bucket_kernel<T> select_bucket_kernel() {
+			Bucket_kernel<T> kernel = nullptr;
+#if defined(CMP_SIMD_X86)
+			const int level = isa_level();
+			if (level >= 3)
+				kernel = avx512_bucket<T>(std::integral_constant<bool, Avx512_lanes<T>::enabled>{});
+			if (!kernel && level >= 2)
+				kernel = avx2_bucket<T>(std::integral_constant<bool, Avx2_lanes<T>::enabled>{});
+			if (!kernel && level >= 1)
+				kernel = sse2_bucket<T>(std::integral_constant<bool, Sse2_lanes<T>::enabled>{});
+#endif
+			return kernel;
+		}
+
+	} /* namespace simd */
+
+	/*
+	 * "Buckets" locates the bin of a value in a sorted chain of bounds,
+	 * e.g. auto bins = cmp::buckets(cmp::chain << 0 < 10 <= 20 < 30);
+	 * The operator before a bound is the upper link of the bin ending at that bound,
+	 * "< b" leaves "b" to the next bin and "<= b" keeps it. The first bound is taken
+	 * as "< b0". So the bins above are (-inf, 0), [0, 10), [10, 20], (20, 30), [30, +inf).
+	 * Each bound is converted to the threshold "x >= t" of the next bin, so a bin
+	 * index is the number of thresholds less than or equal to the value. A single
+	 * value is located by a branchless binary search. A histogram of up to 64 bounds
+	 * is counted by SIMD compares and popcount.
+	 */
+	template<typename T>
+	class Buckets {
+		static_assert(std::is_arithmetic<T>::value && !std::is_same<T, bool>::value,
+			"cmp::buckets requires arithmetic bounds");
+		static constexpr std::size_t lanes = 16; // Padding of the bounds for the widest lane
+		static constexpr std::size_t simd_limit = 64;
+
+		std::vector<T> thresholds_;
+		std::size_t size_;
+		std::size_t bins_;
+		Bucket_kernel<T> kernel_;
+
+	public:
+		Buckets(const T* bounds, const bool* strict, std::size_t count)
+			: size_(0), bins_(count + 1), kernel_(&simd::bucket_scalar<T>) {
+			thresholds_.reserve((count + lanes - 1) / lanes * lanes);
+			for (; size_ < count; ++size_) {
+				T threshold = bounds[size_];
+				if (!strict[size_] && !next_value(threshold))
+					break; // No value passes this bound, nor the following ones
+				thresholds_.push_back(threshold);
+			}
+			if (size_ && size_ <= simd_limit) {
+				static const Bucket_kernel<T> kernel = simd::select_bucket_kernel<T>();
+				if (kernel) {
+					kernel_ = kernel;
+					thresholds_.resize((size_ + lanes - 1) / lanes * lanes, thresholds_.back());
+				}
+			}
+		}
+
+		std::size_t bins() const { return bins_; }
+
+		std::size_t operator()(T value) const {
+			return upper_rank(thresholds_.data(), size_, value);
+		}
+
+		// Adds the bin counts of the array into "counts" of "bins()" elements
+		void histogram(const T* data, std::size_t n, std::size_t* counts) const {
+			kernel_(thresholds_.data(), size_, thresholds_.size(), data, n, counts);
+		}
+
+		template<typename Container>
+		std::vector<std::size_t> histogram(const Container& column) const {
+			std::vector<std::size_t> counts(bins_);
+			histogram(column.data(), column.size(), counts.data());
+			return counts;
+		}
+	};
+
+	template<typename T, typename Store, std::size_t... Inx>
+	Buckets<T> make_buckets(const Store& store, std::index_sequence<Inx...>) {
+		const T bounds[] = { T(value_of(reserve_at<Inx>(store).rhs_))... };
+		const bool strict[] = { !std::is_same<typename std::decay_t<decltype(reserve_at<Inx>(store))>::oper_type,
+			Operation::LowerThanEqual>::value... };
+		return Buckets<T>(bounds, strict, sizeof...(Inx));
+	}
+
+	// The bounds should be sorted, so the chain itself should be true
+	template<typename Policy, std::size_t OperCnt, typename... Previous>
+	Buckets<std::common_type_t<std::decay_t<typename Previous::r_type>...>>
+		buckets(const Conductor<Order::Ascending, Policy, OperCnt, Previous...>& chain) {
+		using value_type = std::common_type_t<std::decay_t<typename Previous::r_type>...>;
+		assert(bool(chain) && "Unsorted bounds");
+		return make_buckets<value_type>(chain.previous_, std::index_sequence_for<Previous...>{});
+	}
+
+	// A rule of "Rule_set", the interval of a single placeholder predicate
+	template<typename T>
+	struct Rule {
+		T lo;
+		T hi;
+		bool lo_strict;
+		bool hi_strict;
+		std::size_t id;
+
+		bool lower_holds(T value) const { return lo_strict ? lo < value : lo <= value; }
+		bool upper_holds(T value) const { return hi_strict ? value < hi : value <= hi; }
+		bool empty() const { return !(lo_strict || hi_strict ? lo < hi : lo <= hi); }
+	};
+
+	/*
+	 * "Interval_tree" is a static centered interval tree of rules.
+	 * Each node keeps the rules containing its center twice, sorted by the lower
+	 * end ascending and by the upper end descending. A lookup visits one node per
+	 * level and stops scanning a node at the first rule which doesn't match,
+	 * so it takes O(log n + k) for "k" matching rules.
+	 */
+	template<typename T>
+	class Interval_tree {
+		struct Tree_node {
+			T center;
+			std::size_t begin; // Rules of the node in "by_lo_" and "by_hi_"
+			std::size_t end;
+			std::size_t left; // Child node indices, "npos" if none
+			std::size_t right;
+		};
+		static constexpr std::size_t npos = std::size_t(-1);
+
+		std::vector<Rule<T>> by_lo_;
+		std::vector<Rule<T>> by_hi_;
+		std::vector<Tree_node> nodes_;
+
+		std::size_t build(std::vector<Rule<T>>& rules) {
+			if (rules.empty())
+				return npos;
+			std::vector<T> ends;
+			ends.reserve(rules.size() * 2);
+			for (const auto& rule : rules) {
+				ends.push_back(rule.lo);
+				ends.push_back(rule.hi);
+			}
+			std::nth_element(ends.begin(), ends.begin() + ends.size() / 2, ends.end());
+			const T center = ends[ends.size() / 2];
+
+			std::vector<Rule<T>> left, right;
+			const std::size_t begin = by_lo_.size();
+			for (const auto& rule : rules) {
+				if (rule.hi < center)
+					left.push_back(rule);
+				else if (center < rule.lo)
+					right.push_back(rule);
+				else {
+					by_lo_.push_back(rule);
+					by_hi_.push_back(rule);
+				}
+			}
+			const std::size_t end = by_lo_.size();
+			// Non-strict ends first, so the matching rules of a node are a prefix
+			std::sort(by_lo_.begin() + begin, by_lo_.end(), [](const Rule<T>& a, const Rule<T>& b) {
+				return a.lo < b.lo || (!(b.lo < a.lo) && a.lo_strict < b.lo_strict);
+			});
+			std::sort(by_hi_.begin() + begin, by_hi_.end(), [](const Rule<T>& a, const Rule<T>& b) {
+				return b.hi < a.hi || (!(a.hi < b.hi) && a.hi_strict < b.hi_strict);
+			});
+
+			const std::size_t inx = nodes_.size();
+			nodes_.push_back({ center, begin, end, npos, npos });
+			std::vector<Rule<T>>().swap(rules);
+			const std::size_t left_inx = build(left);
+			const std::size_t right_inx = build(right);
+			nodes_[inx].left = left_inx;
+			nodes_[inx].right = right_inx;
+			return inx;
+		}
+
+	public:
+		Interval_tree() = default;
+
+		// The rules should not be empty intervals
+		explicit Interval_tree(std::vector<Rule<T>> rules) {
+			by_lo_.reserve(rules.size());
+			by_hi_.reserve(rules.size());
+			build(rules);
+		}
+
+		bool empty() const { return nodes_.empty(); }
+		std::size_t size() const { return by_lo_.size(); }
+		const std::vector<Rule<T>>& rules() const { return by_lo_; }
+
+		// Calls "sink(rule)" for each rule matching the value
+		template<typename Sink>
+		void match(T value, Sink&& sink) const {
+			for (std::size_t inx = nodes_.empty() ? npos : 0; inx != npos;) {
+				const Tree_node& node = nodes_[inx];
+				if (value < node.center) {
+					for (std::size_t rule = node.begin; rule < node.end && by_lo_[rule].lower_holds(value); ++rule)
+						sink(by_lo_[rule]);
+					inx = node.left;
+				}
+				else if (node.center < value) {
+					for (std::size_t rule = node.begin; rule < node.end && by_hi_[rule].upper_holds(value); ++rule)
+						sink(by_hi_[rule]);
+					inx = node.right;
+				}
+				else {
+					// The value is the center or NaN, a strict upper end may still exclude it
+					for (std::size_t rule = node.begin; rule < node.end && by_lo_[rule].lower_holds(value); ++rule)
+						if (by_lo_[rule].upper_holds(value))
+							sink(by_lo_[rule]);
+					inx = npos;
+				}
+			}
+		}
+	};
+
+	/*
+	 * "Rule_set" matches a value against many range rules, e.g.
+	 *   cmp::Rule_set<int> rules;
+	 *   auto id = rules.insert(cmp::chain << lo < cmp::_ <= hi);
+	 *   rules.match(x, [](std::size_t id) { ... });
+	 * Rules are the predicates accepted by "cmp::range", strict and non-strict
+	 * ends are kept. Rule ids are given in insertion order.
+	 * The rules are kept in static interval trees of doubling sizes, the smallest
+	 * rules in a buffer scanned linearly. An insertion merges the full trees into
+	 * the next one, which costs O(log^2 n) amortized. A lookup takes O(log^2 n + k),
+	 * after "compact()" merges everything into a single tree, O(log n + k).
+	 * Removed rules are skipped until they outnumber the live ones.
+	 */
+	template<typename T>
+	class Rule_set {
+		static_assert(std::is_arithmetic<T>::value, "cmp::Rule_set requires arithmetic bounds");
+		static constexpr std::size_t buffer_size = 64;
+
+		std::vector<Rule<T>> buffer_;
+		std::vector<Interval_tree<T>> levels_; // Level "i" holds up to "buffer_size << i" rules
+		std::vector<bool> live_; // Indexed by rule id
+		std::vector<bool> stored_; // Indexed by rule id, empty rules aren't stored
+		std::size_t size_ = 0;
+		std::size_t removed_ = 0; // Removed rules still in the buffer or the trees
+
+		void collect(std::vector<Rule<T>>& rules, const std::vector<Rule<T>>& from) const {
+			for (const auto& rule : from)
+				if (live_[rule.id])
+					rules.push_back(rule);
+		}
+
+		void add(const Rule<T>& rule) {
+			buffer_.push_back(rule);
+			if (buffer_.size() < buffer_size)
+				return;
+			std::vector<Rule<T>> rules;
+			collect(rules, buffer_);
+			std::size_t merged = buffer_.size();
+			buffer_.clear();
+			std::size_t level = 0;
+			for (; level < levels_.size() && !levels_[level].empty(); ++level) {
+				collect(rules, levels_[level].rules());
+				merged += levels_[level].size();
+				levels_[level] = Interval_tree<T>();
+			}
+			removed_ -= merged - rules.size(); // The merge dropped them
+			if (level == levels_.size())
+				levels_.emplace_back();
+			levels_[level] = Interval_tree<T>(std::move(rules));
+		}
+
+	public:
+		using id_type = std::size_t;
+
+		std::size_t size() const { return size_; }
+
+		template<typename Pred>
+		id_type insert(const Pred& pred) {
+			using traits = Range_traits<T, Pred>;
+			static_assert(traits::value, "cmp::Rule_set requires a single placeholder predicate of arithmetic bounds");
+			using bounds_type = typename traits::bounds_type;
+			const bounds_type bounds = traits::bounds(pred);
+			const Rule<T> rule{ bounds.lo, bounds.hi,
+				std::is_same<typename bounds_type::lower_type, Operation::LowerThan>::value,
+				std::is_same<typename bounds_type::upper_type, Operation::LowerThan>::value, live_.size() };
+			live_.push_back(true);
+			stored_.push_back(!rule.empty()); // An empty rule never matches, so it isn't stored
+			++size_;
+			if (stored_.back())
+				add(rule);
+			return rule.id;
+		}
+
+		// Returns false if there is no such rule
+		bool remove(id_type id) {
+			if (id >= live_.size() || !live_[id])
+				return false;
+			live_[id] = false;
+			--size_;
+			if (stored_[id] && ++removed_ > size_)
+				compact();
+			return true;
+		}
+
+		// Merges all of the rules into a single tree, dropping the removed ones
+		void compact() {
+			std::vector<Rule<T>> rules;
+			collect(rules, buffer_);
+			buffer_.clear();
+			for (auto& level : levels_)
+				collect(rules, level.rules());
+			removed_ = 0;
+			std::size_t level = 0;
+			while ((buffer_size << level) < rules.size())
+				++level;
+			levels_.assign(rules.empty() ? 0 : level + 1, Interval_tree<T>());
+			if (!rules.empty())
+				levels_[level] = Interval_tree<T>(std::move(rules));
+		}
+
+		// Calls "sink(id)" for each rule matching the value, in no particular order
+		template<typename Sink>
+		void match(T value, Sink&& sink) const {
+			const auto report = [this, &sink](const Rule<T>& rule) {
+				if (live_[rule.id])
+					sink(rule.id);
+			};
+			for (const auto& rule : buffer_)
+				if (rule.lower_holds(value) && rule.upper_holds(value))
+					report(rule);
+			for (const auto& level : levels_)
+				level.match(value, report);
+		}
+
+		std::vector<id_type> match(T value) const {
+			std::vector<id_type> ids;
+			match(value, [&ids](id_type id) { ids.push_back(id); });
+			return ids;
+		}
+
+		// Calls "sink(inx, id)" for each rule matching "data[inx]"
+		template<typename Sink>
+		void match(const T* data, std::size_t n, Sink&& sink) const {
+			for (std::size_t inx = 0; inx < n; ++inx)
+				match(data[inx], [inx, &sink](id_type id) { sink(inx, id); });
+		}
+	};
+
+	// e.g. auto rules = cmp::rule_set<int>(cmp::chain << 0 < cmp::_ <= 10, cmp::chain << cmp::_ < 5);
+	template<typename T, typename... Preds>
+	Rule_set<T> rule_set(const Preds&... preds) {
+		Rule_set<T> rules;
+		(rules.insert(preds), ...);
+		return rules;
+	}
+
+	// Operator of a "Dynamic_chain" link, given at runtime
+	enum class Link { LowerThan, LowerThanEqual, GreaterThan, GreaterThanEqual };
+
+	// Operand of a "Dynamic_chain", a constant or a placeholder
+	template<typename T>
+	struct Dynamic_operand {
+		static constexpr std::size_t constant = std::size_t(-1);
+		T value;
+		std::size_t arg; // Placeholder index, or "constant"
+
+		Dynamic_operand(const T& value) : value(value), arg(constant) {}
+
+		template<std::size_t N>
+		Dynamic_operand(Arg<N>) : value(), arg(N) {}
+
+		static Dynamic_operand placeholder(std::size_t arg) {
+			Dynamic_operand operand{ T() };
+			operand.arg = arg;
+			return operand;
+		}
+	};
+
+	/*
+	 * "Dynamic_chain" is a comparison chain whose length and operators are known only
+	 * at runtime, e.g. rules of a configuration file. Links are checked to be of a
+	 * single direction when the chain is built, "std::invalid_argument" is thrown otherwise.
+	 * The operands are stored contiguously and the links are compiled into two lists,
+	 * the strict and the non-strict ones, so a link is compared without dispatching
+	 * on its operator. A descending chain is stored reversed, "a > b" as "b < a".
+	 * The result is the same as the template chain of the same operands, including
+	 * the "AllPairs" evaluation of a non-transitive type.
+	 */
+	template<typename T>
+	class Dynamic_chain {
+		static constexpr std::size_t constant = Dynamic_operand<T>::constant;
+
+		std::vector<T> operands_;
+		std::vector<std::size_t> args_; // Placeholder index of each operand
+		std::vector<std::size_t> strict_; // Left operand indices of the strict links
+		std::vector<std::size_t> non_strict_;
+		std::vector<bool> link_strict_;
+		std::size_t arity_ = 0;
+
+		const T& operand(std::size_t inx, const T* args) const {
+			return args_[inx] == constant ? operands_[inx] : args[args_[inx]];
+		}
+
+		// Arithmetic links are combined by "&" without branches, others stop at the first failing link
+		template<typename Op>
+		bool eval_links(const std::vector<std::size_t>& links, const T* args) const {
+			bool result = true;
+			for (std::size_t inx : links) {
+				const bool link = link_compare(Op{}, operand(inx, args), operand(inx + 1, args));
+				if constexpr (!std::is_arithmetic<T>::value) {
+					if (!link)
+						return false;
+				}
+				result &= link;
+			}
+			return result;
+		}
+
+		bool eval_adjacent(const T* args) const {
+			if constexpr (std::is_arithmetic<T>::value)
+				return eval_links<std::less<>>(strict_, args) & eval_links<std::less_equal<>>(non_strict_, args);
+			else
+				return eval_links<std::less<>>(strict_, args) && eval_links<std::less_equal<>>(non_strict_, args);
+		}
+
+		// A pair is compared strictly if any link between them is strict
+		bool eval_all_pairs(const T* args) const {
+			for (std::size_t lhs = 0; lhs + 1 < operands_.size(); ++lhs) {
+				bool strict = false;
+				for (std::size_t rhs = lhs + 1; rhs < operands_.size(); ++rhs) {
+					strict = strict || link_strict_[rhs - 1];
+					if (!(strict ? link_compare(std::less<>{}, operand(lhs, args), operand(rhs, args)) :
+						link_compare(std::less_equal<>{}, operand(lhs, args), operand(rhs, args))))
+						return false;
+				}
+			}
+			return true;
+		}
+
+		static std::uint64_t block_ones(std::size_t count) {
+			return count == 64 ? ~std::uint64_t(0) : (std::uint64_t(1) << count) - 1;
+		}
+
+		// Bits of a link over a block, a constant operand is a single element of "lhs" or "rhs"
+		template<typename Op>
+		static std::uint64_t link_bits(const T* lhs, bool lhs_column, const T* rhs, bool rhs_column, std::size_t count) {
+			std::uint64_t bits = 0;
+			if (lhs_column && rhs_column) {
+				for (std::size_t inx = 0; inx < count; ++inx)
+					bits |= std::uint64_t(link_compare(Op{}, lhs[inx], rhs[inx])) << inx;
+			}
+			else if (lhs_column) {
+				const T& rvalue = *rhs;
+				for (std::size_t inx = 0; inx < count; ++inx)
+					bits |= std::uint64_t(link_compare(Op{}, lhs[inx], rvalue)) << inx;
+			}
+			else if (rhs_column) {
+				const T& lvalue = *lhs;
+				for (std::size_t inx = 0; inx < count; ++inx)
+					bits |= std::uint64_t(link_compare(Op{}, lvalue, rhs[inx])) << inx;
+			}
+			else {
+				bits = link_compare(Op{}, *lhs, *rhs) ? block_ones(count) : 0;
+			}
+			return bits;
+		}
+
+		template<typename Op>
+		std::uint64_t links_bits(const std::vector<std::size_t>& links, const T* const* columns,
+			std::size_t base, std::size_t count, std::uint64_t bits) const {
+			for (std::size_t inx = 0; bits && inx < links.size(); ++inx) {
+				const std::size_t lhs = links[inx];
+				const std::size_t rhs = lhs + 1;
+				bits &= link_bits<Op>(
+					args_[lhs] == constant ? &operands_[lhs] : columns[args_[lhs]] + base, args_[lhs] != constant,
+					args_[rhs] == constant ? &operands_[rhs] : columns[args_[rhs]] + base, args_[rhs] != constant, count);
+			}
+			return bits;
+		}
+
+		// Mask of the "count" rows from "base", "args" is the buffer of a row of a non-transitive type
+		std::uint64_t block_mask(const T* const* columns, std::size_t base, std::size_t count, std::vector<T>& args) const {
+			std::uint64_t bits = block_ones(count);
+			if constexpr (is_transitive<T>::value) {
+				bits = links_bits<std::less<>>(strict_, columns, base, count, bits);
+				bits = links_bits<std::less_equal<>>(non_strict_, columns, base, count, bits);
+			}
+			else {
+				for (std::size_t inx = 0; inx < count; ++inx) {
+					for (std::size_t arg = 0; arg < arity_; ++arg)
+						args[arg] = columns[arg][base + inx];
+					bits &= ~(std::uint64_t(!evaluate(args.data())) << inx);
+				}
+			}
+			return bits;
+		}
+
+		// The row buffer of "block_mask", allocated once for all of the blocks of a call
+		std::vector<T> row_buffer() const {
+			return std::vector<T>(is_transitive<T>::value ? 0 : arity_);
+		}
+
+	public:
+		Dynamic_chain(const std::vector<Dynamic_operand<T>>& operands, const std::vector<Link>& links) {
+			if (operands.empty() || links.size() + 1 != operands.size())
+				throw std::invalid_argument("cmp::Dynamic_chain requires a link between each pair of operands");
+			const auto is_descending = [](Link link) { return link == Link::GreaterThan || link == Link::GreaterThanEqual; };
+			const bool descending = !links.empty() && is_descending(links.front());
+			for (Link link : links)
+				if (is_descending(link) != descending)
+					throw std::invalid_argument("Ambiguously ordered comparison chain");
+
+			const std::size_t size = operands.size();
+			operands_.reserve(size);
+			args_.reserve(size);
+			for (std::size_t inx = 0; inx < size; ++inx) {
+				const auto& operand = operands[descending ? size - 1 - inx : inx];
+				operands_.push_back(operand.value);
+				args_.push_back(operand.arg);
+				if (operand.arg != constant)
+					arity_ = std::max(arity_, operand.arg + 1);
+			}
+			for (std::size_t inx = 0; inx + 1 < size; ++inx) {
+				const Link link = links[descending ? size - 2 - inx : inx];
+				const bool strict = link == Link::LowerThan || link == Link::GreaterThan;
+				(strict ? strict_ : non_strict_).push_back(inx);
+				link_strict_.push_back(strict);
+			}
+		}
+
+		std::size_t size() const { return operands_.size(); }
+		std::size_t arity() const { return arity_; }
+
+		// "args" are the values of the placeholders
+		bool evaluate(const T* args) const {
+			if constexpr (is_transitive<T>::value)
+				return eval_adjacent(args);
+			else
+				return eval_all_pairs(args);
+		}
+
+		template<typename... Args>
+		bool operator()(const Args&... args) const {
+			assert(sizeof...(Args) >= arity_ && "Missing placeholder values");
+			const T values[sizeof...(Args) + 1] = { T(args)... };
+			return evaluate(values);
+		}
+
+		/*
+		 * Batch evaluation, "columns[i]" is the array of the placeholder "i".
+		 * Each block of 64 elements runs the link lists, one link over the whole block at a time.
+		 */
+		void select_mask(const T* const* columns, std::size_t n, std::uint64_t* mask) const {
+			std::vector<T> args = row_buffer();
+			for (std::size_t base = 0, block = 0; base < n; base += 64, ++block)
+				mask[block] = block_mask(columns, base, std::min<std::size_t>(64, n - base), args);
+		}
+
+		void select_mask(const T* data, std::size_t n, std::uint64_t* mask) const {
+			assert(arity_ <= 1 && "A single column for a chain of several placeholders");
+			select_mask(&data, n, mask);
+		}
+
+		std::size_t select_count(const T* data, std::size_t n) const {
+			assert(arity_ <= 1 && "A single column for a chain of several placeholders");
+			std::vector<T> args = row_buffer();
+			std::size_t count = 0;
+			for (std::size_t base = 0; base < n; base += 64)
+				count += popcount64(block_mask(&data, base, std::min<std::size_t>(64, n - base), args));
+			return count;
+		}
+
+		template<typename Container>
+		std::vector<std::uint64_t> select_mask(const Container& column) const {
+			std::vector<std::uint64_t> mask((column.size() + 63) / 64);
+			select_mask(column.data(), column.size(), mask.data());
+			return mask;
+		}
+
+		template<typename Container>
+		std::size_t select_count(const Container& column) const {
+			return select_count(column.data(), column.size());
+		}
+	};
+
+	// e.g. auto rule = cmp::dynamic_chain<int>({ 5, cmp::_, 15 }, { cmp::Link::LowerThan, cmp::Link::LowerThanEqual });
+	template<typename T>
+	Dynamic_chain<T> dynamic_chain(const std::vector<Dynamic_operand<T>>& operands, const std::vector<Link>& links) {
+		return Dynamic_chain<T>(operands, links);
+	}
+
+	/*
+	 * Links of an "Adaptive" predicate are reordered only between operands of
+	 * "is_reorderable" types, whose comparisons neither throw nor have side effects.
+	 * Specialize it as std::true_type for such a user type.
+	 */
+	template<typename T>
+	struct is_reorderable : std::integral_constant<bool, std::is_arithmetic<T>::value || std::is_pointer<T>::value ||
+		std::is_same<T, std::string>::value || std::is_same<T, std::string_view>::value> {};
+
+	// Type of an operand of a predicate called by the arguments "Args"
+	template<typename RType, typename Args>
+	struct resolved_type { using type = RType; };
+
+	template<std::size_t N, typename Args>
+	struct resolved_type<Arg<N>, Args> { using type = std::decay_t<std::tuple_element_t<N, Args>>; };
+
+	/*
+	 * "Adaptive" evaluates the links of a predicate in the order of their observed
+	 * selectivity, the link failing most often first, e.g.
+	 * auto in_box = cmp::adaptive(cmp::chain << 0.4 < cmp::arg<0> <= cmp::arg<1> <= cmp::arg<2> < 0.6).
+	 * Every "sample_period"-th call compares all of the links and counts the failures
+	 * of each one, so a link is sampled regardless of its place in the order. After
+	 * "reorder_samples" samples the links are sorted by their failures and the counts
+	 * are halved, so the order follows a drifting distribution.
+	 * The result is the conjunction of the same links in any order. A link of a
+	 * non-reorderable type keeps its place, the links before it are still compared
+	 * before it and the ones after it after it.
+	 * Comparisons of scalar operands cost less than a mispredicted branch, so their
+	 * links are evaluated by the plan of the least estimated cost: short-circuit in
+	 * the order, short-circuit as written, or all of them without branches. The
+	 * order is used once "set_order" is called.
+	 * Only a non-const call samples and learns. Its counters are members, not
+	 * thread local, so an "Adaptive" must not be called non-const by more than one
+	 * thread; each thread learns by a copy of its own. An "Adaptive" belongs to the
+	 * thread of its first non-const call, a copy to nobody until then. A non-const
+	 * call of another thread fails an assertion at the next sample period.
+	 * A const call evaluates by the current order and changes nothing, so a const
+	 * "Adaptive" can be shared by threads, e.g. a learned and frozen one.
+	 * Pass it by "std::ref" to an algorithm which copies the predicate.
+	 */
+	template<typename Pred>
+	class Adaptive {
+	public:
+		static constexpr std::size_t links = Pred::size() - 1;
+		static constexpr std::uint32_t sample_period = 16;
+		static constexpr std::uint32_t reorder_samples = 256;
+		using order_type = std::array<std::uint8_t, links>;
+
+		explicit Adaptive(const Pred& pred) : pred_(pred) {
+			static_assert(links >= 1 && links <= 255, "Adaptive requires a predicate of 1 to 255 links");
+			for (std::size_t inx = 0; inx < links; ++inx)
+				order_[inx] = std::uint8_t(inx);
+		}
+
+		// Samples every "sample_period"-th call unless frozen
+		template<typename... Args>
+		bool operator()(const Args&... args) {
+			static_assert(sizeof...(Args) == Pred::arity(), "Predicate requires one argument for each placeholder");
+			const auto values = std::forward_as_tuple(args...);
+			using args_type = decltype(values);
+			if (--countdown_ == 0) {
+				countdown_ = sample_period;
+				if (!owner_.thread)
+					owner_.thread = thread_tag();
+				assert(owner_.thread == thread_tag() && "Non-const calls of cmp::Adaptive from more than one thread");
+				if (!frozen_)
+					return sample<args_type>(values);
+			}
+			return evaluate<args_type>(values);
+		}
+
+		// Evaluates by the current order, without sampling
+		template<typename... Args>
+		bool operator()(const Args&... args) const {
+			static_assert(sizeof...(Args) == Pred::arity(), "Predicate requires one argument for each placeholder");
+			const auto values = std::forward_as_tuple(args...);
+			return evaluate<decltype(values)>(values);
+		}
+
+		// Link indices in the order of evaluation, "0" is the link between the first two operands
+		const order_type& order() const { return order_; }
+
+		// Throws std::invalid_argument if "order" isn't a permutation of the links
+		void set_order(const order_type& order) {
+			order_type sorted = order;
+			std::sort(sorted.begin(), sorted.end());
+			for (std::size_t inx = 0; inx < links; ++inx)
+				if (sorted[inx] != inx)
+					throw std::invalid_argument("cmp::Adaptive order requires each link once");
+			order_ = order;
+			plan_ = Plan::Ordered;
+		}
+
+		void freeze() { frozen_ = true; }
+		void unfreeze() { frozen_ = false; }
+		bool frozen() const { return frozen_; }
+
+	private:
+		using captures_type = decltype(std::declval<const Pred&>().captures_);
+
+		// Address of a thread local object, distinct for each thread
+		static const void* thread_tag() {
+			static thread_local char tag;
+			return &tag;
+		}
+
+		// The thread of the non-const calls, not copied
+		struct Owner {
+			const void* thread = nullptr;
+			Owner() = default;
+			Owner(const Owner&) {}
+			Owner& operator=(const Owner&) { return *this; }
+		};
+
+		template<std::size_t Link, typename Args>
+		bool link(const Args& args) const {
+			return compare(resolve(std::get<Link>(pred_.captures_).rhs_, args),
+				resolve(std::get<Link + 1>(pred_.captures_).rhs_, args),
+				typename std::tuple_element_t<Link + 1, captures_type>::oper_type{});
+		}
+
+		template<typename Args, std::size_t... Link>
+		bool link_at(std::size_t inx, const Args& args, std::index_sequence<Link...>) const {
+			bool holds = true;
+			(void)((inx == Link && (holds = link<Link>(args), true)) || ...);
+			return holds;
+		}
+
+		template<typename Args, std::size_t... Position>
+		bool in_order(const Args& args, std::index_sequence<Position...>) const {
+			return (link_at(order_[Position], args, std::make_index_sequence<links>{}) && ...);
+		}
+
+		// Evaluation of scalar links: as written, in the order, or all of them combined by "&"
+		enum class Plan : std::uint8_t { Written, Ordered, Branchless };
+
+		template<typename Args, std::size_t... Link>
+		bool branchless(const Args& args, std::index_sequence<Link...>) const {
+			return (link<Link>(args) & ...);
+		}
+
+		// Links of scalar operands are evaluated by a "Plan"
+		template<typename Args, std::size_t... Operand>
+		static constexpr bool scalar(std::index_sequence<Operand...>) {
+			return (std::is_scalar<typename resolved_type<typename std::tuple_element_t<Operand, captures_type>::r_type,
+				Args>::type>::value && ...);
+		}
+
+		template<typename Args, std::size_t Link>
+		static constexpr bool reorderable() {
+			using lhs_type = typename resolved_type<typename std::tuple_element_t<Link, captures_type>::r_type, Args>::type;
+			using rhs_type = typename resolved_type<typename std::tuple_element_t<Link + 1, captures_type>::r_type, Args>::type;
+			return is_reorderable<lhs_type>::value && is_reorderable<rhs_type>::value;
+		}
+
+		// Segment of each link, a non-reorderable link is a segment of its own
+		template<typename Args, std::size_t... Link>
+		static constexpr std::array<std::size_t, links> segments(std::index_sequence<Link...>) {
+			constexpr bool fixed[] = { !reorderable<Args, Link>()... };
+			std::array<std::size_t, links> segment{};
+			for (std::size_t inx = 1; inx < links; ++inx)
+				segment[inx] = segment[inx - 1] + std::size_t(fixed[inx - 1] || fixed[inx]);
+			return segment;
+		}
+
+		template<typename Args>
+		bool evaluate(const Args& args) const {
+			constexpr std::array<std::size_t, links> segment = segments<Args>(std::make_index_sequence<links>{});
+			if constexpr (segment[links - 1] == 0 && scalar<Args>(std::make_index_sequence<links + 1>{})) {
+				switch (plan_) {
+				case Plan::Ordered:
+					return in_order(args, std::make_index_sequence<links>{});
+				case Plan::Branchless:
+					return branchless(args, std::make_index_sequence<links>{});
+				default:
+					return std::apply(pred_, args);
+				}
+			}
+			else if constexpr (segment[links - 1] == 0) {
+				return in_order(args, std::make_index_sequence<links>{});
+			}
+			else {
+				for (std::size_t current = 0; current <= segment[links - 1]; ++current)
+					for (std::size_t inx = 0; inx < links; ++inx)
+						if (segment[order_[inx]] == current && !link_at(order_[inx], args, std::make_index_sequence<links>{}))
+							return false;
+			}
+			return true;
+		}
+
+		// Every link of a segment is compared, the segments after a failing one are not
+		template<typename Args>
+		bool sample(const Args& args) {
+			constexpr std::array<std::size_t, links> segment = segments<Args>(std::make_index_sequence<links>{});
+			bool result = true;
+			if constexpr (segment[links - 1] == 0) {
+				result = count_fails(args, std::make_index_sequence<links>{});
+			}
+			else {
+				for (std::size_t current = 0; result && current <= segment[links - 1]; ++current) {
+					for (std::size_t inx = 0; inx < links; ++inx) {
+						if (segment[inx] == current && !link_at(inx, args, std::make_index_sequence<links>{})) {
+							++fails_[inx];
+							result = false;
+						}
+					}
+				}
+			}
+			if (++samples_ == reorder_samples)
+				reorder();
+			return result;
+		}
+
+		// Counts without branches, a sample is as unpredictable as the data
+		template<typename Args, std::size_t... Link>
+		bool count_fails(const Args& args, std::index_sequence<Link...>) {
+			const bool holds[] = { link<Link>(args)... };
+			bool result = true;
+			for (std::size_t inx = 0; inx < links; ++inx) {
+				fails_[inx] += !holds[inx];
+				result &= holds[inx];
+			}
+			return result;
+		}
+
+		/*
+		 * Estimated cost of a short-circuit in "order", in comparisons, assuming
+		 * independent links. Each link reached costs a comparison and "dispatch" to
+		 * find it. A link other than the last one is a branch, mispredicted for the
+		 * less frequent of its outcomes at the cost of about 24 comparisons.
+		 */
+		double cost(const order_type& order, double dispatch) const {
+			double total = 0, reach = 1;
+			for (std::size_t inx = 0; inx < links; ++inx) {
+				const double fails = double(fails_[order[inx]]) / double(weight_);
+				total += reach * (1 + dispatch + (inx + 1 < links ? 24 * std::min(fails, 1 - fails) : 0));
+				reach *= 1 - fails;
+			}
+			return total;
+		}
+
+		void reorder() {
+			std::stable_sort(order_.begin(), order_.end(), [this](std::uint8_t lhs, std::uint8_t rhs) {
+				return fails_[lhs] > fails_[rhs];
+			});
+			weight_ += samples_;
+			order_type written;
+			for (std::size_t inx = 0; inx < links; ++inx)
+				written[inx] = std::uint8_t(inx);
+			// Scalar links are evaluated by the cheapest plan
+			const double ordered = cost(order_, 3), as_written = cost(written, 0), all = 2 * double(links);
+			plan_ = ordered < as_written && ordered < all ? Plan::Ordered : all < as_written ? Plan::Branchless : Plan::Written;
+			for (auto& fails : fails_)
+				fails /= 2;
+			weight_ /= 2;
+			samples_ = 0;
+		}
+
+		Pred pred_;
+		order_type order_;
+		std::array<std::uint32_t, links> fails_{};
+		std::uint32_t samples_ = 0;
+		std::uint32_t weight_ = 0; // Samples, halved with the failures
+		std::uint32_t countdown_ = sample_period; // Calls until the next sample
+		Plan plan_ = Plan::Written; // Of scalar links, the others are compared in the order
+		bool frozen_ = false;
+		Owner owner_;
+	};
+
+	template<typename Pred>
+	Adaptive<Pred> adaptive(const Pred& pred) {
+		return Adaptive<Pred>(pred);
+	}
+
+	// Links of every adjacent pair for "is_chain" and "chain_until", e.g. cmp::is_chain(keys, cmp::strict)
+	constexpr Operation::LowerThan strict{};
+	constexpr Operation::LowerThanEqual non_strict{};
+
+	/*
+	 * Checks the links [begin, end) of an array and returns the first failing one,
+	 * or "end". The link "i" is between the elements "i - 1" and "i", so begin >= 1.
+	 */
+	template<typename T>
+	using Until_kernel = std::size_t(*)(const T* data, std::size_t begin, std::size_t end);
+
+	// "a > b" is checked as "b < a" by the lanes
+	template<typename OperType>
+	struct Lane_link { using lower_type = OperType; static constexpr bool swap = false; };
+
+	template<>
+	struct Lane_link<Operation::GreaterThan> { using lower_type = Operation::LowerThan; static constexpr bool swap = true; };
+
+	template<>
+	struct Lane_link<Operation::GreaterThanEqual> { using lower_type = Operation::LowerThanEqual; static constexpr bool swap = true; };
+
+	namespace simd {
+
+		template<typename T, typename OperType>
+		std::size_t until_scalar(const T* data, std::size_t begin, std::size_t end) {
+			for (std::size_t inx = begin; inx < end; ++inx)
+				if (!compare(data[inx - 1], data[inx], OperType{}))
+					return inx;
+			return end;
+		}
+
+#if defined(CMP_SIMD_X86)
+		// Overlapping loads compare each lane with its neighbour, "data + inx - 1" against "data + inx"
+		template<typename Lanes, typename T, typename OperType>
+		__attribute__((target("sse2")))
+		std::size_t until_sse2(const T* data, std::size_t begin, std::size_t end) {
+			using link = Lane_link<OperType>;
+			const unsigned full = unsigned((std::uint64_t(1) << Lanes::width) - 1);
+			std::size_t inx = begin;
+			for (; inx + Lanes::width <= end; inx += Lanes::width) {
+				const auto prev = Lanes::load(data + inx - 1);
+				const auto next = Lanes::load(data + inx);
+				const auto holds = link::swap ? Lanes::less(next, prev, typename link::lower_type{}) :
+					Lanes::less(prev, next, typename link::lower_type{});
+				const unsigned bits = Lanes::bits(holds, holds);
+				if (bits != full)
+					return inx + ctz64(~std::uint64_t(bits));
+			}
+			return until_scalar<T, OperType>(data, inx, end);
+		}
+
+		template<typename Lanes, typename T, typename OperType>
+		__attribute__((target("avx2")))
+		std::size_t until_avx2(const T* data, std::size_t begin, std::size_t end) {
+			using link = Lane_link<OperType>;
+			const unsigned full = unsigned((std::uint64_t(1) << Lanes::width) - 1);
+			std::size_t inx = begin;
+			for (; inx + Lanes::width <= end; inx += Lanes::width) {
+				const auto prev = Lanes::load(data + inx - 1);
+				const auto next = Lanes::load(data + inx);
+				const auto holds = link::swap ? Lanes::less(next, prev, typename link::lower_type{}) :
+					Lanes::less(prev, next, typename link::lower_type{});
+				const unsigned bits = Lanes::bits(holds, holds);
+				if (bits != full)
+					return inx + ctz64(~std::uint64_t(bits));
+			}
+			return until_scalar<T, OperType>(data, inx, end);
+		}
+
+		template<typename Lanes, typename T, typename OperType>
+		__attribute__((target("avx512f")))
+		std::size_t until_avx512(const T* data, std::size_t begin, std::size_t end) {
+			using link = Lane_link<OperType>;
+			const unsigned full = unsigned((std::uint64_t(1) << Lanes::width) - 1);
+			std::size_t inx = begin;
+			for (; inx + Lanes::width <= end; inx += Lanes::width) {
+				const auto prev = Lanes::load(data + inx - 1);
+				const auto next = Lanes::load(data + inx);
+				const auto holds = link::swap ? Lanes::less(next, prev, typename link::lower_type{}) :
+					Lanes::less(prev, next, typename link::lower_type{});
+				const unsigned bits = Lanes::bits(holds, holds);
+				if (bits != full)
+					return inx + ctz64(~std::uint64_t(bits));
+			}
+			return until_scalar<T, OperType>(data, inx, end);
+		}
+
+		template<typename T, typename OperType>
+		Until_kernel<T> sse2_until(std::true_type) { return &until_sse2<Sse2_lanes<T>, T, OperType>; }
+		template<typename T, typename OperType>
+		Until_kernel<T> sse2_until(std::false_type) { return nullptr; }
+
+		template<typename T, typename OperType>
+		Until_kernel<T> avx2_until(std::true_type) { return &until_avx2<Avx2_lanes<T>, T, OperType>; }
+		template<typename T, typename OperType>
+		Until_kernel<T> avx2_until(std::false_type) { return nullptr; }
+
+		template<typename T, typename OperType>
+		Until_kernel<T> avx512_until(std::true_type) { return &until_avx512<Avx512_lanes<T>, T, OperType>; }
+		template<typename T, typename OperType>
+		Until_kernel<T> avx512_until(std::false_type) { return nullptr; }
+#endif
+
+		template<typename T, typename OperType>
+		Until_kernel<T> select_until_kernel() {
+			Until_kernel<T> kernel = nullptr;
+#if defined(CMP_SIMD_X86)
+			const int level = isa_level();
+			if (level >= 3)
+				kernel = avx512_until<T, OperType>(std::integral_constant<bool, Avx512_lanes<T>::enabled>{});
+			if (!kernel && level >= 2)
+				kernel = avx2_until<T, OperType>(std::integral_constant<bool, Avx2_lanes<T>::enabled>{});
+			if (!kernel && level >= 1)
+				kernel = sse2_until<T, OperType>(std::integral_constant<bool, Sse2_lanes<T>::enabled>{});
+#endif
+			return kernel ? kernel : &until_scalar<T, OperType>;
+		}
+
+	} /* namespace simd */
+
+#ifndef CMP_PARALLEL_THRESHOLD
+#define CMP_PARALLEL_THRESHOLD (std::size_t(1) << 22)
+#endif
+
+	/*
+	 * Runs "until(begin, end)" over the links [1, n) and returns the first failing link, or "n".
+	 * An input of at least CMP_PARALLEL_THRESHOLD elements is split into a chunk per hardware
+	 * thread. A chunk starts with the link to the last element of the previous chunk,
+	 * so the boundaries are checked too. A chunk is checked by steps of "until_step" links,
+	 * the lowest failing link found so far is shared, and a step past it isn't checked.
+	 */
+	constexpr std::size_t until_step = std::size_t(1) << 16;
+
+	inline std::size_t parallel_threads(std::size_t n) {
+		return n < CMP_PARALLEL_THRESHOLD ? 1 : std::max<std::size_t>(1, std::thread::hardware_concurrency());
+	}
+
+	/*
+	 * Worker threads of a parallel algorithm, joined when it goes out of scope, so a
+	 * thread that fails to start or an exception of the calling thread doesn't leave
+	 * a joinable thread behind. The first exception of "call", in any of the threads,
+	 * is kept and "join" rethrows it in the calling thread. Declare it after the state
+	 * the workers use, it must be destroyed first.
+	 */
+	class Workers {
+	public:
+		Workers() = default;
+		Workers(const Workers&) = delete;
+		Workers& operator=(const Workers&) = delete;
+		~Workers() { join_threads(); }
+
+		template<typename Func>
+		void start(Func func) {
+			threads_.emplace_back([this, func] { call(func); });
+		}
+
+		template<typename Func>
+		void call(const Func& func) noexcept {
+			try {
+				func();
+			}
+			catch (...) {
+				if (!failed_.exchange(true))
+					error_ = std::current_exception();
+			}
+		}
+
+		// Lets the others stop early once a call has thrown
+		bool failed() const { return failed_.load(std::memory_order_relaxed); }
+
+		void join() {
+			join_threads();
+			if (error_)
+				std::rethrow_exception(error_);
+		}
+
+	private:
+		void join_threads() noexcept {
+			for (auto& thread : threads_)
+				if (thread.joinable())
+					thread.join();
+		}
+
+		std::vector<std::thread> threads_;
+		std::atomic<bool> failed_{ false };
+		std::exception_ptr error_; // Written by the first failing call only, read after the join
+	};
+
+	template<typename Until>
+	std::size_t parallel_until(const Until& until, std::size_t n, std::size_t threads) {
+		if (n < 2)
+			return n;
+		if (threads <= 1)
+			return until(1, n);
+
+		const std::size_t chunk = (n - 1 + threads - 1) / threads;
+		std::atomic<std::size_t> first{ n };
+		const auto run = [&](std::size_t inx, const Workers& workers) {
+			const std::size_t end = std::min(n, 1 + (inx + 1) * chunk);
+			for (std::size_t begin = std::min(n, 1 + inx * chunk); begin < end; begin += until_step) {
+				if (first.load(std::memory_order_relaxed) < begin || workers.failed())
+					return;
+				const std::size_t step_end = std::min(end, begin + until_step);
+				const std::size_t found = until(begin, step_end);
+				if (found < step_end) {
+					std::size_t current = first.load(std::memory_order_relaxed);
+					while (found < current && !first.compare_exchange_weak(current, found, std::memory_order_relaxed)) {}
+					return;
+				}
+			}
+		};
+		Workers workers;
+		for (std::size_t inx = 1; inx < threads; ++inx)
+			workers.start([&run, &workers, inx] { run(inx, workers); });
+		workers.call([&run, &workers] { run(0, workers); });
+		workers.join();
+		return first.load(std::memory_order_relaxed);
+	}
+
+	/*
+	 * A non-transitive type is checked by all pairs, the same as "Node::evaluate".
+	 * A pair is compared strictly if any link between them is strict, "holds(lhs, rhs, strict)"
+	 * compares it, so only the operators of the chain are instantiated.
+	 */
+	template<typename T, typename Strict, typename Holds>
+	std::size_t until_all_pairs(const T* data, std::size_t n, Strict is_strict, Holds holds) {
+		for (std::size_t rhs = 1; rhs < n; ++rhs) {
+			bool strict = false;
+			for (std::size_t lhs = rhs; lhs-- > 0;) {
+				strict = strict || is_strict(lhs + 1);
+				if (!holds(data[lhs], data[rhs], strict))
+					return rhs;
+			}
+		}
+		return n;
+	}
+
+	/*
+	 * "chain_until" returns the first position "i" where the chain
+	 * "data[0] op data[1] op ... op data[i]" fails, or "n" if the whole array is a chain.
+	 * The link is one of cmp::strict, cmp::non_strict or another Operation tag.
+	 * Arithmetic arrays are compared by SSE2, AVX2 or AVX-512 lanes of adjacent elements.
+	 */
+	template<typename T, typename OperType>
+	std::size_t chain_until(const T* data, std::size_t n, OperType) {
+		if constexpr (!is_transitive<T>::value) {
+			constexpr bool descending = std::is_same<OperType, Operation::GreaterThan>::value ||
+				std::is_same<OperType, Operation::GreaterThanEqual>::value;
+			constexpr bool strict = std::is_same<OperType, Operation::LowerThan>::value ||
+				std::is_same<OperType, Operation::GreaterThan>::value;
+			return until_all_pairs(data, n, [](std::size_t) { return strict; }, [](const T& lhs, const T& rhs, bool strict_pair) {
+				if constexpr (descending)
+					return strict_pair ? compare(lhs, rhs, Operation::GreaterThan{}) : compare(lhs, rhs, Operation::GreaterThanEqual{});
+				else
+					return strict_pair ? compare(lhs, rhs, Operation::LowerThan{}) : compare(lhs, rhs, Operation::LowerThanEqual{});
+			});
+		}
+		else {
+			static const Until_kernel<T> kernel = simd::select_until_kernel<T, OperType>();
+			return parallel_until([data](std::size_t begin, std::size_t end) { return kernel(data, begin, end); },
+				n, parallel_threads(n));
+		}
+	}
+
+	// The links repeat the pattern, e.g. { Link::LowerThan, Link::LowerThanEqual } for "a < b <= c < d ..."
+	template<typename T>
+	std::size_t chain_until(const T* data, std::size_t n, const std::vector<Link>& pattern) {
+		const auto is_descending = [](Link link) { return link == Link::GreaterThan || link == Link::GreaterThanEqual; };
+		if (pattern.empty())
+			throw std::invalid_argument("cmp::chain_until requires a link pattern");
+		const bool descending = is_descending(pattern.front());
+		std::vector<char> strict;
+		for (Link link : pattern) {
+			if (is_descending(link) != descending)
+				throw std::invalid_argument("Ambiguously ordered comparison chain");
+			strict.push_back(link == Link::LowerThan || link == Link::GreaterThan);
+		}
+		const std::size_t period = pattern.size();
+
+		if constexpr (!is_transitive<T>::value) {
+			// "a > b" is compared as "b < a", the same as the links of a transitive type
+			return until_all_pairs(data, n, [&](std::size_t inx) { return bool(strict[(inx - 1) % period]); },
+				[descending](const T& lhs, const T& rhs, bool strict_pair) {
+					return strict_pair ? compare(descending ? rhs : lhs, descending ? lhs : rhs, Operation::LowerThan{}) :
+						compare(descending ? rhs : lhs, descending ? lhs : rhs, Operation::LowerThanEqual{});
+				});
+		}
+		else {
+			// A pattern of a single link is a uniform chain
+			if (std::all_of(pattern.begin(), pattern.end(), [&](Link link) { return link == pattern.front(); })) {
+				switch (pattern.front()) {
+				case Link::LowerThan: return chain_until(data, n, Operation::LowerThan{});
+				case Link::LowerThanEqual: return chain_until(data, n, Operation::LowerThanEqual{});
+				case Link::GreaterThan: return chain_until(data, n, Operation::GreaterThan{});
+				case Link::GreaterThanEqual: return chain_until(data, n, Operation::GreaterThanEqual{});
+				}
+			}
+
+			return parallel_until([&](std::size_t begin, std::size_t end) {
+				std::size_t phase = (begin - 1) % period;
+				for (std::size_t inx = begin; inx < end; ++inx) {
+					const T& lhs = descending ? data[inx] : data[inx - 1];
+					const T& rhs = descending ? data[inx - 1] : data[inx];
+					if (!(strict[phase] ? compare(lhs, rhs, Operation::LowerThan{}) : compare(lhs, rhs, Operation::LowerThanEqual{})))
+						return inx;
+					phase = phase + 1 == period ? 0 : phase + 1;
+				}
+				return end;
+			}, n, parallel_threads(n));
+		}
+	}
+
+	template<typename T, typename Links>
+	bool is_chain(const T* data, std::size_t n, const Links& links) {
+		return chain_until(data, n, links) == n;
+	}
+
+	template<typename Container, typename Links>
+	std::size_t chain_until(const Container& range, const Links& links) {
+		return chain_until(range.data(), range.size(), links);
+	}
+
+	template<typename Container, typename Links>
+	bool is_chain(const Container& range, const Links& links) {
+		return is_chain(range.data(), range.size(), links);
+	}
+
+	/*
+	 * "Columns" binds equal length arrays to the placeholders of a predicate,
+	 * the column "i" to "arg<i>", e.g.
+	 * cmp::select_count(cmp::chain << 0.4 < cmp::arg<0> <= cmp::arg<1> < 0.6, cmp::columns(a, b)).
+	 */
+	template<typename... Types>
+	struct Columns {
+		std::tuple<const Types*...> data;
+		std::size_t size;
+	};
+
+	template<typename... Types>
+	Columns<Types...> columns(std::size_t n, const Types*... data) {
+		return{ { data... }, n };
+	}
+
+	template<typename Container, typename... Containers, typename = decltype(std::declval<const Container&>().data())>
+	auto columns(const Container& first, const Containers&... rest) {
+		if (((rest.size() != first.size()) || ...))
+			throw std::invalid_argument("cmp::columns requires columns of the same length");
+		return Columns<std::decay_t<decltype(*first.data())>, std::decay_t<decltype(*rest.data())>...>{
+			{ first.data(), rest.data()... }, first.size() };
+	}
+
+	/*
+	 * A link of a predicate over columns, "lhs[row * lhs_step] op rhs[row * rhs_step]".
+	 * A constant operand is an array of copies read with a zero step,
+	 * so every link is a compare of two loads whatever its operands are.
+	 */
+	template<typename T>
+	struct Column_link {
+		const T* lhs;
+		const T* rhs;
+		std::size_t lhs_step;
+		std::size_t rhs_step;
+	};
+
+	// Each kernel ANDs the links into the mask words of the rows [row, row + 64 * words)
+	template<typename T>
+	using Columns_kernel = void(*)(const Column_link<T>* links, std::size_t count, std::size_t row,
+		std::size_t words, std::uint64_t* masks);
+
+	namespace simd {
+
+		template<typename T, typename OperType>
+		void columns_scalar(const Column_link<T>* links, std::size_t count, std::size_t row,
+			std::size_t words, std::uint64_t* masks) {
+			for (const Column_link<T>* link = links; link != links + count; ++link) {
+				for (std::size_t word = 0; word < words; ++word) {
+					const std::size_t base = row + word * 64;
+					std::uint64_t bits = 0;
+					for (std::size_t inx = 0; inx < 64; ++inx)
+						bits |= std::uint64_t(compare(link->lhs[(base + inx) * link->lhs_step],
+							link->rhs[(base + inx) * link->rhs_step], OperType{})) << inx;
+					masks[word] &= bits;
+				}
+			}
+		}
+
+#if defined(CMP_SIMD_X86)
+		template<typename Lanes, typename T, typename OperType>
+		__attribute__((target("sse2")))
+		void columns_sse2(const Column_link<T>* links, std::size_t count, std::size_t row,
+			std::size_t words, std::uint64_t* masks) {
+			for (const Column_link<T>* link = links; link != links + count; ++link) {
+				for (std::size_t word = 0; word < words; ++word) {
+					const std::size_t base = row + word * 64;
+					std::uint64_t bits = 0;
+					for (std::size_t inx = 0; inx < 64; inx += Lanes::width) {
+						const auto holds = Lanes::less(Lanes::load(link->lhs + (base + inx) * link->lhs_step),
+							Lanes::load(link->rhs + (base + inx) * link->rhs_step), OperType{});
+						bits |= std::uint64_t(Lanes::bits(holds, holds)) << inx;
+					}
+					masks[word] &= bits;
+				}
+			}
+		}
+
+		template<typename Lanes, typename T, typename OperType>
+		__attribute__((target("avx2")))
+		void columns_avx2(const Column_link<T>* links, std::size_t count, std::size_t row,
+			std::size_t words, std::uint64_t* masks) {
+			for (const Column_link<T>* link = links; link != links + count; ++link) {
+				for (std::size_t word = 0; word < words; ++word) {
+					const std::size_t base = row + word * 64;
+					std::uint64_t bits = 0;
+					for (std::size_t inx = 0; inx < 64; inx += Lanes::width) {
+						const auto holds = Lanes::less(Lanes::load(link->lhs + (base + inx) * link->lhs_step),
+							Lanes::load(link->rhs + (base + inx) * link->rhs_step), OperType{});
+						bits |= std::uint64_t(Lanes::bits(holds, holds)) << inx;
+					}
+					masks[word] &= bits;
+				}
+			}
+		}
+
+		template<typename Lanes, typename T, typename OperType>
+		__attribute__((target("avx512f")))
+		void columns_avx512(const Column_link<T>* links, std::size_t count, std::size_t row,
+			std::size_t words, std::uint64_t* masks) {
+			for (const Column_link<T>* link = links; link != links + count; ++link) {
+				for (std::size_t word = 0; word < words; ++word) {
+					const std::size_t base = row + word * 64;
+					std::uint64_t bits = 0;
+					for (std::size_t inx = 0; inx < 64; inx += Lanes::width) {
+						const auto holds = Lanes::less(Lanes::load(link->lhs + (base + inx) * link->lhs_step),
+							Lanes::load(link->rhs + (base + inx) * link->rhs_step), OperType{});
+						bits |= std::uint64_t(Lanes::bits(holds, holds)) << inx;
+					}
+					masks[word] &= bits;
+				}
+			}
+		}
+
+		template<typename T, typename OperType>
+		Columns_kernel<T> sse2_columns(std::true_type) { return &columns_sse2<Sse2_lanes<T>, T, OperType>; }
+		template<typename T, typename OperType>
+		Columns_kernel<T> sse2_columns(std::false_type) { return nullptr; }
+
+		template<typename T, typename OperType>
+		Columns_kernel<T> avx2_columns(std::true_type) { return &columns_avx2<Avx2_lanes<T>, T, OperType>; }
+		template<typename T, typename OperType>
+		Columns_kernel<T> avx2_columns(std::false_type) { return nullptr; }
+
+		template<typename T, typename OperType>
+		Columns_kernel<T> avx512_columns(std::true_type) { return &columns_avx512<Avx512_lanes<T>, T, OperType>; }
+		template<typename T, typename OperType>
+		Columns_kernel<T> avx512_columns(std::false_type) { return nullptr; }
+#endif
+
+		template<typename T, typename OperType>
+		Columns_kernel<T> select_columns_kernel() {
+			Columns_kernel<T> kernel = nullptr;
+#if defined(CMP_SIMD_X86)
+			const int level = isa_level();
+			if (level >= 3)
+				kernel = avx512_columns<T, OperType>(std::integral_constant<bool, Avx512_lanes<T>::enabled>{});
+			if (!kernel && level >= 2)
+				kernel = avx2_columns<T, OperType>(std::integral_constant<bool, Avx2_lanes<T>::enabled>{});
+			if (!kernel && level >= 1)
+				kernel = sse2_columns<T, OperType>(std::integral_constant<bool, Sse2_lanes<T>::enabled>{});
+#endif
+			return kernel ? kernel : &columns_scalar<T, OperType>;
+		}
+
+	} /* namespace simd */
+
+	// Operands of a predicate which can be read as a column of T
+	template<typename T, typename RType>
+	struct is_column_operand : is_exact_bound<T, RType> {};
+
+	template<typename T, std::size_t N>
+	struct is_column_operand<T, Arg<N>> : std::true_type {};
+
+	// Predicates evaluated by the column kernels, the columns of an arithmetic type and exact constants
+	template<typename Pred, typename... Types>
+	struct Column_traits : std::false_type {};
+
+	template<typename Policy, typename... Captures, typename T, typename... Types>
+	struct Column_traits<Predicate<Order::Ascending, Policy, Captures...>, T, Types...> : std::integral_constant<bool,
+		std::is_arithmetic<T>::value && (std::is_same<T, Types>::value && ...) &&
+		(is_column_operand<T, typename Captures::r_type>::value && ...)> {};
+
+	/*
+	 * The links of a predicate split into the strict and the non-strict lists,
+	 * each list is evaluated by a single kernel call per block.
+	 */
+	template<typename T, std::size_t Size>
+	class Column_plan {
+		T constants_[Size][16];
+		Column_link<T> strict_[Size];
+		Column_link<T> non_strict_[Size];
+		std::size_t strict_count_ = 0;
+		std::size_t non_strict_count_ = 0;
+
+		template<std::size_t N>
+		const T* operand(std::size_t, Arg<N>, const T* const* columns, std::size_t& step) {
+			step = 1;
+			return columns[N];
+		}
+
+		template<typename RType>
+		const T* operand(std::size_t inx, const RType& value, const T* const*, std::size_t& step) {
+			std::fill(constants_[inx], constants_[inx] + 16, T(value));
+			step = 0;
+			return constants_[inx];
+		}
+
+	public:
+		template<typename... Captures, std::size_t... Inx>
+		Column_plan(const std::tuple<Captures...>& captures, const T* const* columns, std::index_sequence<Inx...>) {
+			std::size_t step[Size] = {};
+			const T* const data[Size] = { operand(Inx, std::get<Inx>(captures).rhs_, columns, step[Inx])... };
+			const bool strict[Size] = { std::is_same<typename Captures::oper_type, Operation::LowerThan>::value... };
+			for (std::size_t inx = 1; inx < Size; ++inx) {
+				const Column_link<T> link = { data[inx - 1], data[inx], step[inx - 1], step[inx] };
+				if (strict[inx])
+					strict_[strict_count_++] = link;
+				else
+					non_strict_[non_strict_count_++] = link;
+			}
+		}
+
+		Column_plan(const Column_plan&) = delete;
+		Column_plan& operator=(const Column_plan&) = delete;
+
+		void operator()(std::size_t row, std::size_t words, std::uint64_t* masks) const {
+			static const Columns_kernel<T> strict_kernel = simd::select_columns_kernel<T, Operation::LowerThan>();
+			static const Columns_kernel<T> non_strict_kernel = simd::select_columns_kernel<T, Operation::LowerThanEqual>();
+			std::fill(masks, masks + words, ~std::uint64_t(0));
+			strict_kernel(strict_, strict_count_, row, words, masks);
+			non_strict_kernel(non_strict_, non_strict_count_, row, words, masks);
+		}
+	};
+
+	/*
+	 * Calls "task(inx)" for each of the "count" tasks. The threads claim the next task
+	 * from a shared counter, so a thread done with cheap tasks takes over the remaining ones
+	 * instead of waiting for a thread stuck with expensive ones.
+	 */
+	template<typename Task>
+	void parallel_tasks(std::size_t count, std::size_t threads, const Task& task) {
+		std::atomic<std::size_t> next{ 0 };
+		Workers workers;
+		const auto run = [&] {
+			for (std::size_t inx; !workers.failed() && (inx = next.fetch_add(1, std::memory_order_relaxed)) < count;)
+				task(inx);
+		};
+		for (std::size_t inx = 1; inx < std::min(threads, count); ++inx)
+			workers.start(run);
+		workers.call(run);
+		workers.join();
+	}
+
+	namespace simd {
+
+		// Rows of a task, and of a block evaluated link by link while its columns are in the cache
+		constexpr std::size_t column_task_words = 256;
+		constexpr std::size_t column_block_words = 32;
+
+		template<typename Pred, typename... Types, std::size_t... Inx>
+		std::uint64_t column_row_bits(const Pred& pred, const std::tuple<const Types*...>& data,
+			std::size_t begin, std::size_t end, std::index_sequence<Inx...>) {
+			std::uint64_t bits = 0;
+			for (std::size_t row = begin; row < end; ++row)
+				bits |= std::uint64_t(bool(pred(std::get<Inx>(data)[row]...))) << (row % 64);
+			return bits;
+		}
+
+		/*
+		 * Calls "sink(word, masks, words)" for each block of the columns, from several threads.
+		 * A task is owned by a single thread, so the sink may write the words
+		 * or the task "word / column_task_words" without a lock.
+		 */
+		template<typename Pred, typename... Types, typename Sink>
+		void scan_columns(const Pred& pred, const Columns<Types...>& columns, std::size_t threads, const Sink& sink) {
+			static_assert(sizeof...(Types) == Pred::arity(), "Predicate requires one column for each placeholder");
+			const std::size_t n = columns.size;
+			const std::size_t words = (n + 63) / 64;
+			const std::size_t full = n / 64;
+			const auto indices = std::index_sequence_for<Types...>{};
+
+			const auto run = [&](const auto& block) {
+				parallel_tasks((words + column_task_words - 1) / column_task_words, threads, [&](std::size_t task) {
+					std::uint64_t masks[column_block_words];
+					const std::size_t end = std::min(words, (task + 1) * column_task_words);
+					for (std::size_t word = task * column_task_words; word < end; word += column_block_words) {
+						const std::size_t count = std::min(column_block_words, end - word);
+						const std::size_t kernel_words = std::min(count, full - std::min(full, word));
+						block(word, kernel_words, masks);
+						for (std::size_t inx = kernel_words; inx < count; ++inx) {
+							const std::size_t begin = (word + inx) * 64;
+							masks[inx] = column_row_bits(pred, columns.data, begin, std::min(n, begin + 64), indices);
+						}
+						sink(word, static_cast<const std::uint64_t*>(masks), count);
+					}
+				});
+			};
+
+			if constexpr (Column_traits<Pred, Types...>::value) {
+				using T = std::tuple_element_t<0, std::tuple<Types...>>;
+				const auto data = std::apply([](auto... column) {
+					return std::array<const T*, sizeof...(Types)>{ { column... } };
+				}, columns.data);
+				const Column_plan<T, Pred::size()> plan(pred.captures_, data.data(), std::make_index_sequence<Pred::size()>{});
+				run([&](std::size_t word, std::size_t count, std::uint64_t* masks) { plan(word * 64, count, masks); });
+			}
+			else {
+				run([&](std::size_t word, std::size_t count, std::uint64_t* masks) {
+					for (std::size_t inx = 0; inx < count; ++inx) {
+						const std::size_t begin = (word + inx) * 64;
+						masks[inx] = column_row_bits(pred, columns.data, begin, begin + 64, indices);
+					}
+				});
+			}
+		}
+
+	} /* namespace simd */
+
+	/*
+	 * Batch evaluation of a predicate of several placeholders over columns, e.g.
+	 * cmp::select_index(cmp::chain << 0.4 < cmp::arg<0> <= cmp::arg<1> <= cmp::arg<2> < 0.6, cmp::columns(a, b, c)).
+	 * Columns of the same int32, int64, float or double type with constants of that type are
+	 * evaluated link by link over blocks of 2048 rows by SSE2, AVX2 or AVX-512 kernels.
+	 * The blocks are grouped into tasks of 16384 rows shared by "threads" threads,
+	 * by default a single thread below CMP_PARALLEL_THRESHOLD rows and a thread per core above.
+	 */
+	template<typename Pred, typename... Types>
+	void select_mask(const Pred& pred, const Columns<Types...>& columns, std::uint64_t* mask, std::size_t threads) {
+		simd::scan_columns(pred, columns, threads, [mask](std::size_t word, const std::uint64_t* masks, std::size_t count) {
+			std::copy(masks, masks + count, mask + word);
+		});
+	}
+
+	template<typename Pred, typename... Types>
+	void select_mask(const Pred& pred, const Columns<Types...>& columns, std::uint64_t* mask) {
+		select_mask(pred, columns, mask, parallel_threads(columns.size));
+	}
+
+	// Writes the indices of the matching rows in ascending order and returns their count
+	template<typename Pred, typename... Types>
+	std::size_t select_index(const Pred& pred, const Columns<Types...>& columns, std::size_t* index, std::size_t threads) {
+		const std::size_t words = (columns.size + 63) / 64;
+		const std::size_t tasks = (words + simd::column_task_words - 1) / simd::column_task_words;
+		std::vector<std::uint64_t> mask(words);
+		std::vector<std::size_t> offsets(tasks + 1);
+		simd::scan_columns(pred, columns, threads, [&](std::size_t word, const std::uint64_t* masks, std::size_t count) {
+			std::size_t& matches = offsets[word / simd::column_task_words + 1];
+			for (std::size_t inx = 0; inx < count; ++inx) {
+				mask[word + inx] = masks[inx];
+				matches += popcount64(masks[inx]);
+			}
+		});
+		for (std::size_t task = 1; task <= tasks; ++task)
+			offsets[task] += offsets[task - 1];
+
+		// Each task writes its indices from the total count of the tasks before it
+		parallel_tasks(tasks, threads, [&](std::size_t task) {
+			std::size_t* out = index + offsets[task];
+			const std::size_t end = std::min(words, (task + 1) * simd::column_task_words);
+			for (std::size_t word = task * simd::column_task_words; word < end; ++word)
+				for (std::uint64_t bits = mask[word]; bits; bits &= bits - 1)
+					*out++ = word * 64 + ctz64(bits);
+		});
+		return offsets[tasks];
+	}
+
+	template<typename Pred, typename... Types>
+	std::size_t select_index(const Pred& pred, const Columns<Types...>& columns, std::size_t* index) {
+		return select_index(pred, columns, index, parallel_threads(columns.size));
+	}
+
+	template<typename Pred, typename... Types>
+	std::size_t select_count(const Pred& pred, const Columns<Types...>& columns, std::size_t threads) {
+		std::vector<std::size_t> counts((columns.size + 64 * simd::column_task_words - 1) / (64 * simd::column_task_words));
+		simd::scan_columns(pred, columns, threads, [&counts](std::size_t word, const std::uint64_t* masks, std::size_t count) {
+			std::size_t& matches = counts[word / simd::column_task_words];
+			for (std::size_t inx = 0; inx < count; ++inx)
+				matches += popcount64(masks[inx]);
+		});
+		std::size_t count = 0;
+		for (std::size_t matches : counts)
+			count += matches;
+		return count;
+	}
+
+	template<typename Pred, typename... Types>
+	std::size_t select_count(const Pred& pred, const Columns<Types...>& columns) {
+		return select_count(pred, columns, parallel_threads(columns.size));
+	}
+
+	template<typename Pred, typename... Types>
+	std::vector<std::uint64_t> select_mask(const Pred& pred, const Columns<Types...>& columns) {
+		std::vector<std::uint64_t> mask((columns.size + 63) / 64);
+		select_mask(pred, columns, mask.data());
+		return mask;
+	}
+
+	template<typename Pred, typename... Types>
+	std::vector<std::size_t> select_index(const Pred& pred, const Columns<Types...>& columns) {
+		std::vector<std::size_t> index(columns.size);
+		index.resize(select_index(pred, columns, index.data()));
+		return index;
+	}
+
+	/*
+	 * "Sorted_bounds" reads the bounds of the predicates "lo < _ < hi", "_ < hi" and "lo < _"
+	 * (any of "<" may be "<=") for a search in sorted data. "before(x)" is true for the
+	 * elements sorted before the matching ones, "after(x)" for the ones sorted after them.
+	 */
+	template<typename Pred>
+	struct Sorted_bounds : std::false_type {};
+
+	template<typename LType, typename LowerOp, typename UpperOp, typename HType, typename Policy>
+	struct Sorted_bounds<Predicate<Order::Ascending, Policy, Capture<LType, Operation::ChainBegin>,
+		Capture<Arg<0>, LowerOp>, Capture<HType, UpperOp>>> : std::true_type {
+		template<typename Pred, typename T>
+		static bool before(const Pred& pred, const T& x) { return !compare(std::get<0>(pred.captures_).rhs_, x, LowerOp{}); }
+		template<typename Pred, typename T>
+		static bool after(const Pred& pred, const T& x) { return !compare(x, std::get<2>(pred.captures_).rhs_, UpperOp{}); }
+	};
+
+	template<typename UpperOp, typename HType, typename Policy>
+	struct Sorted_bounds<Predicate<Order::Ascending, Policy, Capture<Arg<0>, Operation::ChainBegin>,
+		Capture<HType, UpperOp>>> : std::true_type {
+		template<typename Pred, typename T>
+		static bool before(const Pred&, const T&) { return false; }
+		template<typename Pred, typename T>
+		static bool after(const Pred& pred, const T& x) { return !compare(x, std::get<1>(pred.captures_).rhs_, UpperOp{}); }
+	};
+
+	template<typename LType, typename LowerOp, typename Policy>
+	struct Sorted_bounds<Predicate<Order::Ascending, Policy, Capture<LType, Operation::ChainBegin>,
+		Capture<Arg<0>, LowerOp>>> : std::true_type {
+		template<typename Pred, typename T>
+		static bool before(const Pred& pred, const T& x) { return !compare(std::get<0>(pred.captures_).rhs_, x, LowerOp{}); }
+		template<typename Pred, typename T>
+		static bool after(const Pred&, const T&) { return false; }
+	};
+
+	// A view of the elements [first, last) found by "equal_range"
+	template<typename Iterator>
+	class Subrange {
+		Iterator first_;
+		Iterator last_;
+
+	public:
+		constexpr Subrange(Iterator first, Iterator last) : first_(first), last_(last) {}
+
+		constexpr Iterator begin() const { return first_; }
+		constexpr Iterator end() const { return last_; }
+		constexpr std::size_t size() const { return std::size_t(last_ - first_); }
+		constexpr bool empty() const { return first_ == last_; }
+	};
+
+	/*
+	 * The first elements of [first, first + n) for which "before" and "within" are false,
+	 * by two branchless binary searches run side by side. The searches do not wait for
+	 * each other's cache misses, and the next middle elements are prefetched.
+	 */
+	template<typename Iterator, typename Before, typename Within>
+	std::pair<Iterator, Iterator> partition_points(Iterator first, std::size_t n, const Before& before, const Within& within) {
+		if (!n)
+			return{ first, first };
+		Iterator lower = first;
+		Iterator upper = first;
+		for (; n > 1; n -= n / 2) {
+#if defined(__GNUC__)
+			__builtin_prefetch(std::addressof(lower[n / 4]));
+			__builtin_prefetch(std::addressof(lower[n / 2 + n / 4]));
+			__builtin_prefetch(std::addressof(upper[n / 4]));
+			__builtin_prefetch(std::addressof(upper[n / 2 + n / 4]));
+#endif
+			lower = before(lower[n / 2]) ? lower + n / 2 : lower;
+			upper = within(upper[n / 2]) ? upper + n / 2 : upper;
+		}
+		lower = before(*lower) ? lower + 1 : lower;
+		upper = within(*upper) ? upper + 1 : upper;
+		return{ lower, std::max(lower, upper) };
+	}
+
+	/*
+	 * "equal_range" of data sorted in ascending order returns the elements matching
+	 * the predicate "lo < _ < hi", "_ < hi" or "lo < _" (any of "<" may be "<="),
+	 * the same as a filter by the predicate but by two binary searches.
+	 * "lo <= _" starts at lower_bound(lo), "lo < _" at upper_bound(lo),
+	 * "_ < hi" ends at lower_bound(hi) and "_ <= hi" at upper_bound(hi).
+	 */
+	template<typename Iterator, typename Pred>
+	Subrange<Iterator> equal_range(Iterator first, Iterator last, const Pred& pred) {
+		using bounds = Sorted_bounds<Pred>;
+		static_assert(bounds::value, "cmp::equal_range requires a predicate of the form lo < _ < hi, _ < hi or lo < _");
+		const auto points = partition_points(first, std::size_t(last - first),
+			[&](const auto& x) { return bounds::before(pred, x); },
+			[&](const auto& x) { return !bounds::after(pred, x); });
+		return{ points.first, points.second };
+	}
+
+	template<typename Container, typename Pred>
+	auto equal_range(const Container& sorted, const Pred& pred) {
+		return cmp::equal_range(std::begin(sorted), std::end(sorted), pred);
+	}
+
+	/*
+	 * "Eytzinger_index" keeps a copy of sorted data in the breadth first order of a binary
+	 * search tree, the children of the node "k" are "2k" and "2k + 1". A search reads
+	 * the nodes of the top levels from a few cache lines and prefetches the ones
+	 * four levels ahead, which pays off for many queries on the same data.
+	 * The rank of a node in the data is computed from its index, so the index
+	 * takes no more memory than the copy of the data.
+	 * The data must outlive the index, "equal_range" returns a view of it.
+	 */
+	template<typename T>
+	class Eytzinger_index {
+		const T* data_;
+		std::size_t size_;
+		std::vector<T> keys_;
+		unsigned levels_; // Levels of the tree, the last one may not be full
+		std::size_t leaves_; // Nodes of the last level
+
+		std::size_t build(std::size_t node, std::size_t rank) {
+			if (node <= size_) {
+				rank = build(2 * node, rank);
+				keys_[node] = data_[rank++];
+				rank = build(2 * node + 1, rank);
+			}
+			return rank;
+		}
+
+		/*
+		 * In a perfect tree of "levels_" levels, the node "2^d + b" of the depth "d" has
+		 * the rank "(2b + 1) * 2^(levels_ - 1 - d) - 1", and the leaf "b" the rank "2b".
+		 * The leaves missing from the last level are the ones past "leaves_", so each
+		 * one ranked before the node lowers its rank by one.
+		 */
+		std::size_t rank_of(std::size_t node) const {
+			const unsigned depth = log2_64(node);
+			const std::size_t perfect = ((2 * (node - (std::size_t(1) << depth)) + 1) << (levels_ - 1 - depth)) - 1;
+			const std::size_t leaves_before = (perfect + 1) / 2;
+			return perfect - (leaves_before > leaves_ ? leaves_before - leaves_ : 0);
+		}
+
+		// Ranks of the first elements for which "before" and "within" are false, searched side by side
+		template<typename Before, typename Within>
+		std::pair<std::size_t, std::size_t> search(const Before& before, const Within& within) const {
+			constexpr std::size_t ahead = std::max<std::size_t>(1, 64 / sizeof(T));
+			std::size_t lower = 1;
+			std::size_t upper = 1;
+			// The last level is not full, so one search may leave the tree a step before the other
+			while (lower <= size_ || upper <= size_) {
+#if defined(__GNUC__)
+				__builtin_prefetch(keys_.data() + std::min(lower * ahead, size_));
+				__builtin_prefetch(keys_.data() + std::min(upper * ahead, size_));
+#endif
+				lower = lower <= size_ ? 2 * lower + before(keys_[lower]) : lower;
+				upper = upper <= size_ ? 2 * upper + within(keys_[upper]) : upper;
+			}
+			// The last nodes where the searches turned left
+			lower >>= ctz64(~std::uint64_t(lower)) + 1;
+			upper >>= ctz64(~std::uint64_t(upper)) + 1;
+			return{ lower ? rank_of(lower) : size_, upper ? rank_of(upper) : size_ };
+		}
+
+	public:
+		Eytzinger_index(const T* sorted, std::size_t n) : data_(sorted), size_(n), keys_(n + 1),
+			levels_(n ? log2_64(n) + 1 : 0), leaves_(n ? n - ((std::size_t(1) << (levels_ - 1)) - 1) : 0) {
+			build(1, 0);
+		}
+
+		template<typename Container>
+		explicit Eytzinger_index(const Container& sorted) : Eytzinger_index(sorted.data(), sorted.size()) {}
+
+		std::size_t size() const { return size_; }
+
+		template<typename Pred>
+		Subrange<const T*> equal_range(const Pred& pred) const {
+			using bounds = Sorted_bounds<Pred>;
+			static_assert(bounds::value, "cmp::equal_range requires a predicate of the form lo < _ < hi, _ < hi or lo < _");
+			const auto ranks = search([&](const T& x) { return bounds::before(pred, x); },
+				[&](const T& x) { return !bounds::after(pred, x); });
+			return{ data_ + ranks.first, data_ + std::max(ranks.first, ranks.second) };
+		}
+	};
+
+	template<typename Container>
+	auto eytzinger_index(const Container& sorted) {
+		return Eytzinger_index<std::decay_t<decltype(*sorted.data())>>(sorted);
+	}
+
+	template<typename T, typename Pred>
+	Subrange<const T*> equal_range(const Eytzinger_index<T>& index, const Pred& pred) {
+		return index.equal_range(pred);
+	}
 
 } /* namespace cmp */
 